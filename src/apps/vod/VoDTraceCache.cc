@@ -0,0 +1,196 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "VoDTraceCache.h"
+
+std::map<std::string, VoDTrace*> VoDTraceCache::traces_;
+
+namespace {
+
+/**
+ * Read-only mapping of a whole file. Where mmap is not
+ * available the file is read into memory at once
+ */
+class MappedFile
+{
+  public:
+    MappedFile(const std::string& fileName)
+    {
+        data_ = NULL;
+        size_ = 0;
+
+        struct stat buf;
+        if (stat(fileName.c_str(), &buf))
+            throw cRuntimeError("Error while opening input file (File not found or incorrect type)");
+        size_ = buf.st_size;
+        if (size_ == 0)
+            return;
+
+#ifdef _WIN32
+        FILE* fp = fopen(fileName.c_str(), "rb");
+        if (fp == NULL)
+            throw cRuntimeError("can't open file %s", fileName.c_str());
+        copy_.resize(size_);
+        if (fread(&copy_[0], 1, size_, fp) != size_)
+        {
+            fclose(fp);
+            throw cRuntimeError("read failed");
+        }
+        fclose(fp);
+        data_ = &copy_[0];
+#else
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw cRuntimeError("can't open file %s", fileName.c_str());
+        void* addr = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED)
+            throw cRuntimeError("can't map file %s", fileName.c_str());
+        data_ = (const char*) addr;
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (data_ != NULL)
+            munmap((void*) data_, size_);
+#endif
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+  private:
+    const char* data_;
+    size_t size_;
+#ifdef _WIN32
+    std::vector<char> copy_;
+#endif
+};
+
+/**
+ * Extracts the next whitespace-separated token starting at pos.
+ * Returns false if there are no more tokens
+ */
+bool nextToken(const char* data, size_t size, size_t& pos, std::string& token)
+{
+    while (pos < size && isspace((unsigned char) data[pos]))
+        pos++;
+    if (pos >= size)
+        return false;
+    size_t start = pos;
+    while (pos < size && !isspace((unsigned char) data[pos]))
+        pos++;
+    token.assign(data + start, pos - start);
+    return true;
+}
+
+}
+
+const VoDTrace* VoDTraceCache::acquire(const std::string& fileName, bool svc)
+{
+    std::string key = (svc ? "SVC:" : "NS2:") + fileName;
+    std::map<std::string, VoDTrace*>::iterator it = traces_.find(key);
+    if (it != traces_.end())
+    {
+        it->second->refCount++;
+        return it->second;
+    }
+
+    VoDTrace* trace = new VoDTrace();
+    trace->fileName = fileName;
+    trace->svc = svc;
+    trace->refCount = 1;
+    try
+    {
+        MappedFile file(fileName);
+        if (svc)
+            loadSvc(trace, file.data(), file.size());
+        else
+            loadNs2(trace, file.data(), file.size());
+    }
+    catch (...)
+    {
+        delete trace;
+        throw;
+    }
+
+    traces_[key] = trace;
+    return trace;
+}
+
+void VoDTraceCache::release(const VoDTrace* trace)
+{
+    if (trace == NULL)
+        return;
+
+    std::string key = (trace->svc ? "SVC:" : "NS2:") + trace->fileName;
+    std::map<std::string, VoDTrace*>::iterator it = traces_.find(key);
+    if (it == traces_.end() || it->second != trace)
+        return;
+    if (--it->second->refCount == 0)
+    {
+        delete it->second;
+        traces_.erase(it);
+    }
+}
+
+void VoDTraceCache::loadNs2(VoDTrace* trace, const char* data, size_t size)
+{
+    // ns2 traces are sequences of (time, size) pairs in network byte order
+    const size_t recordSize = 2 * sizeof(uint32_t);
+    if (size % recordSize != 0)
+        throw cRuntimeError("bad file size in %s", trace->fileName.c_str());
+
+    size_t nrec = size / recordSize;
+    trace->ns2.resize(nrec);
+    const unsigned char* p = (const unsigned char*) data;
+    for (size_t i = 0; i < nrec; i++, p += recordSize)
+    {
+        trace->ns2[i].time = ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+        trace->ns2[i].size = ((uint32_t) p[4] << 24) | ((uint32_t) p[5] << 16) | ((uint32_t) p[6] << 8) | p[7];
+    }
+}
+
+void VoDTraceCache::loadSvc(VoDTrace* trace, const char* data, size_t size)
+{
+    // each line is: memoryAdd length lid tid qid frameType isDiscardable
+    //               isTruncatable frameNumber timestamp isControl
+    const unsigned int numFields = 11;
+    std::string fields[numFields];
+    size_t pos = 0;
+    while (true)
+    {
+        unsigned int n = 0;
+        while (n < numFields && nextToken(data, size, pos, fields[n]))
+            n++;
+        if (n < numFields)
+            break;    // end of file (a trailing incomplete record is ignored)
+
+        VoDSvcRecord rec;
+        rec.length = atoi(fields[1].c_str());
+        rec.lid = atoi(fields[2].c_str());
+        rec.tid = atoi(fields[3].c_str());
+        rec.qid = atoi(fields[4].c_str());
+        rec.frameNumber = atoi(fields[8].c_str());
+        rec.timestamp = atoi(fields[9].c_str());
+        trace->svcRecords.push_back(rec);
+    }
+}
@@ -0,0 +1,90 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_VODTRACECACHE_H_
+#define _LTE_VODTRACECACHE_H_
+
+#include <omnetpp.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace omnetpp;
+
+/**
+ * One record of an ns2-style binary trace, in host byte order
+ */
+struct VoDNs2Record
+{
+    uint32_t time;
+    uint32_t size;
+};
+
+/**
+ * One record of an SVC trace. Only the fields used
+ * by the server are kept, in native form
+ */
+struct VoDSvcRecord
+{
+    int tid;
+    int lid;
+    int qid;
+    int length;
+    int frameNumber;
+    int timestamp;
+};
+
+/**
+ * Read-only view of a parsed trace, shared by all the servers
+ * that use the same trace file
+ */
+struct VoDTrace
+{
+    std::string fileName;
+    bool svc;
+    std::vector<VoDNs2Record> ns2;
+    std::vector<VoDSvcRecord> svcRecords;
+    unsigned int refCount;
+};
+
+/**
+ * \class VoDTraceCache
+ * \brief Process-wide cache of VoD trace files
+ *
+ * Each trace file is memory-mapped and converted to its native
+ * layout only once, the first time a VoDUDPServer asks for it.
+ * Following requests for the same file get the same read-only
+ * view. The view is freed when the last server releases it.
+ */
+class VoDTraceCache
+{
+  public:
+    /**
+     * Returns the parsed trace for the given file, loading it on first use
+     *
+     * @param fileName trace file
+     * @param svc true for SVC (text) traces, false for ns2 (binary) traces
+     */
+    static const VoDTrace* acquire(const std::string& fileName, bool svc);
+
+    /**
+     * Drops a reference to the given trace
+     */
+    static void release(const VoDTrace* trace);
+
+  private:
+    static void loadNs2(VoDTrace* trace, const char* data, size_t size);
+    static void loadSvc(VoDTrace* trace, const char* data, size_t size);
+
+    /// Loaded traces, indexed by file name and trace type
+    static std::map<std::string, VoDTrace*> traces_;
+};
+
+#endif
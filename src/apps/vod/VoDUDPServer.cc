@@ -16,9 +16,11 @@ Define_Module(VoDUDPServer);
 
 VoDUDPServer::VoDUDPServer()
 {
+    trace_ = NULL;
 }
 VoDUDPServer::~VoDUDPServer()
 {
+    VoDTraceCache::release(trace_);
 }
 
 void VoDUDPServer::initialize(int stage)
@@ -42,63 +44,10 @@ void VoDUDPServer::initialize(int stage)
 
     if (!inputFileName.empty())
     {
-        // Check whether string is empty
-        if (traceType == "SVC")
-        {
-            infile.open(inputFileName.c_str(), ios::in);
-            if (infile.bad()) /* Or file is bad */
-                throw cRuntimeError("Error while opening input file (File not found or incorrect type)");
-
-            infile.seekg(0, ios::beg);
-            long int i = 0;
-            while (!infile.eof())
-            {
-                svcPacket tmp;
-                tmp.index = i;
-                infile >> tmp.memoryAdd >> tmp.length >> tmp.lid >> tmp.tid >> tmp.qid >>
-                    tmp.frameType >> tmp.isDiscardable >> tmp.isTruncatable >> tmp.frameNumber
-                    >> tmp.timestamp >> tmp.isControl;
-                svcTrace_.push_back(tmp);
-                i++;
-            }
-            svcPacket tmp;
-            tmp.index = LONG_MAX;
-            svcTrace_.push_back(tmp);
-        }
-        else
-        {
-            tracerec t;
-            struct stat buf;
-            FILE *fp;
-
-            /* only open/read the file once (could be shared by multiple
-             * SourceModel's
-             */
-
-            if (stat(inputFileName.c_str(), (struct stat *) &buf))
-                throw cRuntimeError("Error while opening input file (File not found or incorrect type)");
-
-            nrec_ = buf.st_size / sizeof(tracerec);
-            unsigned nrecplus = nrec_ * sizeof(tracerec);
-            unsigned bufst = buf.st_size;
-            //      if ((unsigned)(nrec_ * sizeof(tracerec)) != buf.st_size) {
-            if (nrecplus != bufst)
-                throw cRuntimeError("bad file size in %s", inputFileName.c_str());
-
-            trace_ = new tracerec[nrec_];
-
-            if ((fp = fopen(inputFileName.c_str(), "rb")) == NULL)
-                throw cRuntimeError("can't open file %s", inputFileName.c_str());
-
-            for (unsigned int i = 0; i < nrec_; i++)
-            {
-                if (fread((char *) &t, sizeof(tracerec), 1, fp) != 1)
-                    throw cRuntimeError("read failed");
-                trace_[i].trec_time = ntohl(t.trec_time);
-                trace_[i].trec_size = ntohl(t.trec_size);
-            }
-            fclose(fp);
-        }
+        // the trace is loaded only once and shared by all the servers using it
+        trace_ = VoDTraceCache::acquire(inputFileName, traceType == "SVC");
+        if (traceType != "SVC" && trace_->ns2.empty())
+            throw cRuntimeError("empty trace file %s", inputFileName.c_str());
     }
 
     /* Initialize parameters after the initialize() method */
@@ -111,8 +60,6 @@ void VoDUDPServer::initialize(int stage)
 
 void VoDUDPServer::finish()
 {
-    if (infile.is_open())
-        infile.close();
 }
 
 void VoDUDPServer::handleMessage(cMessage *msg)
@@ -179,8 +126,9 @@ void VoDUDPServer::handleNS2Message(cMessage *msg)
     int length;//, interTime;
 
     int seq_num = numPkSentApp;
-    //interTime = trace_[numPkSentApp % nrec_].trec_time;
-    length = trace_[numPkSentApp % nrec_].trec_size;
+    //interTime = trace[numPkSentApp % trace.size()].time;
+    const std::vector<VoDNs2Record>& trace = trace_->ns2;
+    length = trace[numPkSentApp % trace.size()].size;
 
     VoDPacket* frame = new VoDPacket("VoDPacket");
     frame->setFrameSeqNum(seq_num);
@@ -202,7 +150,9 @@ void VoDUDPServer::handleSVCMessage(cMessage *msg)
 {
     M1Message* msgNew = (M1Message*) msg;
     long numPkSentApp = msgNew->getNumPkSent();
-    if (svcTrace_[numPkSentApp].index == LONG_MAX)
+    const std::vector<VoDSvcRecord>& svcTrace = trace_->svcRecords;
+    long numRecords = svcTrace.size();
+    if (numPkSentApp >= numRecords)
     {
         /* End of file, send finish packet */
         cPacket* fm = new cPacket("VoDFinishPacket");
@@ -212,35 +162,35 @@ void VoDUDPServer::handleSVCMessage(cMessage *msg)
     else
     {
         int seq_num = numPkSentApp;
-        int currentFrame = svcTrace_[numPkSentApp].frameNumber;
+        int currentFrame = svcTrace[numPkSentApp].frameNumber;
 
         VoDPacket* frame = new VoDPacket("VoDPacket");
         frame->setFrameSeqNum(seq_num);
         frame->setTimestamp(simTime());
-        frame->setByteLength(svcTrace_[numPkSentApp].length);
-        frame->setTid(svcTrace_[numPkSentApp].tid);
-        frame->setQid(svcTrace_[numPkSentApp].qid);
-        frame->setFrameLength(svcTrace_[numPkSentApp].length + 2 * sizeof(int)); /* Seq_num plus frame length plus payload */
+        frame->setByteLength(svcTrace[numPkSentApp].length);
+        frame->setTid(svcTrace[numPkSentApp].tid);
+        frame->setQid(svcTrace[numPkSentApp].qid);
+        frame->setFrameLength(svcTrace[numPkSentApp].length + 2 * sizeof(int)); /* Seq_num plus frame length plus payload */
         socket.sendTo(frame, msgNew->getClientAddr(), msgNew->getClientPort());
         numPkSentApp++;
         while (1)
         {
             /* Get infos about the frame from file */
 
-            if (svcTrace_[numPkSentApp].index == LONG_MAX)
+            if (numPkSentApp >= numRecords)
                 break;
 
             int seq_num = numPkSentApp;
-            if (svcTrace_[numPkSentApp].frameNumber != currentFrame)
+            if (svcTrace[numPkSentApp].frameNumber != currentFrame)
                 break; // Finish sending packets belonging to the current frame
 
             VoDPacket* frame = new VoDPacket("VoDPacket");
-            frame->setTid(svcTrace_[numPkSentApp].tid);
-            frame->setQid(svcTrace_[numPkSentApp].qid);
+            frame->setTid(svcTrace[numPkSentApp].tid);
+            frame->setQid(svcTrace[numPkSentApp].qid);
             frame->setFrameSeqNum(seq_num);
             frame->setTimestamp(simTime());
-            frame->setByteLength(svcTrace_[numPkSentApp].length);
-            frame->setFrameLength(svcTrace_[numPkSentApp].length + 2 * sizeof(int)); /* Seq_num plus frame length plus payload */
+            frame->setByteLength(svcTrace[numPkSentApp].length);
+            frame->setFrameLength(svcTrace[numPkSentApp].length + 2 * sizeof(int)); /* Seq_num plus frame length plus payload */
             socket.sendTo(frame, msgNew->getClientAddr(), msgNew->getClientPort());
             EV << " VoDUDPServer::handleSVCMessage sending frame " << seq_num << std::endl;
             numPkSentApp++;
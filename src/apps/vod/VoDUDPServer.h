@@ -14,6 +14,7 @@
 #include <omnetpp.h>
 #include <fstream>
 #include "VoDUDPStruct.h"
+#include "VoDTraceCache.h"
 #include "UDPControlInfo_m.h"
 #include "VoDPacket_m.h"
 #include "M1Message_m.h"
@@ -30,7 +31,6 @@ class VoDUDPServer : public cSimpleModule
     /* Server parameters */
 
     int serverPort;
-    ifstream infile;
     string inputFileName;
     int fps;
     string traceType;
@@ -54,32 +54,8 @@ class VoDUDPServer : public cSimpleModule
     unsigned int numStreams;  // number of video streams served
     unsigned long numPkSent;  // total number of packets sent
 
-    struct tracerec
-    {
-        uint32_t trec_time;
-        uint32_t trec_size;
-    };
-    struct svcPacket
-    {
-        int tid;
-        int lid;
-        int qid;
-        int length;
-        int frameNumber;
-        int timestamp;
-        int currentFrame;
-        string memoryAdd;
-        string isDiscardable;
-        string isTruncatable;
-        string isControl;
-        string frameType;
-        long int index;
-    };
-    unsigned int nrec_;
-
-    tracerec* trace_;
-
-    std::vector<svcPacket> svcTrace_;
+    /// Parsed trace, shared with the other servers using the same file
+    const VoDTrace* trace_;
 
   public:
     VoDUDPServer();
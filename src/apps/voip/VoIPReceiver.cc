@@ -14,17 +14,6 @@ Define_Module(VoIPReceiver);
 
 VoIPReceiver::~VoIPReceiver()
 {
-    while (!mPlayoutQueue_.empty())
-    {
-        delete mPlayoutQueue_.front();
-        mPlayoutQueue_.pop_front();
-    }
-
-    while (!mPacketsList_.empty())
-    {
-        delete mPacketsList_.front();
-        mPacketsList_.pop_front();
-    }
 }
 
 void VoIPReceiver::initialize(int stage)
@@ -37,10 +26,16 @@ void VoIPReceiver::initialize(int stage)
     emodel_A_ = par("emodel_A_");
     emodel_Ro_ = par("emodel_Ro_");
 
-    mBufferSpace_ = par("dim_buffer");
+    int bufferSize = par("dim_buffer");
+    if (bufferSize < 0)
+        throw cRuntimeError("VoIPReceiver::initialize - dim_buffer must be non-negative");
+    mPlayoutRing_.resize(bufferSize);
+    mPlayoutHead_ = 0;
+    mPlayoutCount_ = 0;
     mSamplingDelta_ = par("sampling_time");
     mPlayoutDelay_ = par("playout_delay");
 
+    mReceivedFrames_ = 0;
     mInit_ = true;
 
     int port = par("localPort");
@@ -101,143 +96,149 @@ void VoIPReceiver::handleMessage(cMessage *msg)
     emit(voipReceivedThroughtput_lte_, &t );
 
     pPacket->setArrivalTime(simTime());
-    mPacketsList_.push_back(pPacket);
+    playoutPacket(pPacket);
 }
 
-void VoIPReceiver::playout(bool finish)
+void VoIPReceiver::startTalkspurt(VoipPacket* pPacket)
 {
-    if (mPacketsList_.empty())
-        return;
-
-    double sample;
-
-    VoipPacket* pPacket = mPacketsList_.front();
-
-    simtime_t firstPlayoutTime = pPacket->getArrivalTime() + mPlayoutDelay_;
-    unsigned int firstFrameId = pPacket->getIDframe();
-    unsigned int n_frames = pPacket->getNframes();
-    unsigned int playoutLoss = 0;
-    unsigned int tailDropLoss = 0;
-    unsigned int channelLoss;
+    mFirstPlayoutTime_ = pPacket->getArrivalTime() + mPlayoutDelay_;
+    mTalkspurtFrames_ = pPacket->getNframes();
+    mMaxFrameId_ = 0;
+    mPlayoutLoss_ = 0;
+    mTailDropLoss_ = 0;
+    mMaxJitter_ = -1000.0;
+
+    // frames can wait at most the playout delay before being played out,
+    // plus the time spent in the playout buffer
+    unsigned int windowSize = mPlayoutRing_.size() + 1;
+    if (mSamplingDelta_ > 0)
+        windowSize += (unsigned int) ceil(SIMTIME_DBL(mPlayoutDelay_) / SIMTIME_DBL(mSamplingDelta_));
+    mArrived_.assign(windowSize, UINT_MAX);
+    mArrivedBase_ = 0;
+}
 
-    if (finish)
-    {
-        PacketsList::iterator it;
-        unsigned int maxId = 0;
-        for (it = mPacketsList_.begin(); it != mPacketsList_.end(); it++)
-            maxId = std::max(maxId, (*it)->getIDframe());
-        channelLoss = maxId + 1 - mPacketsList_.size();
-    }
+void VoIPReceiver::playoutPacket(VoipPacket* pPacket)
+{
+    if (mReceivedFrames_ == 0)
+        startTalkspurt(pPacket);
 
-    else
-        channelLoss = pPacket->getNframes() - mPacketsList_.size();
+    ++mReceivedFrames_;
 
-    sample = ((double) channelLoss / (double) n_frames);
-    emit(voIPFrameLossSignal_, sample);
+    double sample = SIMTIME_DBL(pPacket->getArrivalTime() - pPacket->getTimestamp());
+    emit(voIPFrameDelaySignal_, sample);
 
-    //Vector for managing duplicates
-    bool* isArrived = new bool[pPacket->getNframes()];
-    for (unsigned int y = 0; y < pPacket->getNframes(); y++)
-    {
-        isArrived[y] = false;
-    }
+    unsigned int IDframe = pPacket->getIDframe();
+    mMaxFrameId_ = std::max(mMaxFrameId_, IDframe);
 
-    simtime_t last_jitter = 0.0;
-    simtime_t max_jitter = -1000.0;
+    pPacket->setPlayoutTime(mFirstPlayoutTime_ + IDframe * mSamplingDelta_);
 
-    while (!mPacketsList_.empty() /*&& pPacket->getIDtalk() == mCurrentTalkspurt*/)
-    {
-        pPacket = mPacketsList_.front();
+    simtime_t last_jitter = pPacket->getArrivalTime() - pPacket->getPlayoutTime();
+    mMaxJitter_ = std::max(mMaxJitter_, last_jitter);
 
-        sample = SIMTIME_DBL(pPacket->getArrivalTime() - pPacket->getTimestamp());
-        emit(voIPFrameDelaySignal_, sample);
+    EV << "VoIPReceiver::playout - Jitter measured: " << last_jitter << " TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
 
-        unsigned int IDframe = pPacket->getIDframe();
+    if (IDframe >= mArrivedBase_ + mArrived_.size())
+        mArrivedBase_ = IDframe + 1 - mArrived_.size();
 
-        pPacket->setPlayoutTime(firstPlayoutTime + IDframe * mSamplingDelta_);
-        //pPacket->setPlayoutTime(firstPlayoutTime + (pPacket->getIDframe() - firstFrameId) * mSamplingDelta_);
+    unsigned int slot = IDframe % mArrived_.size();
 
-        last_jitter = pPacket->getArrivalTime() - pPacket->getPlayoutTime();
-        max_jitter = std::max(max_jitter, last_jitter);
+    if (IDframe < mArrivedBase_)
+    {
+        ++mPlayoutLoss_;
 
-        EV << "VoIPReceiver::playout - Jitter measured: " << last_jitter << " TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
+        EV << "VoIPReceiver::playout - packet older than the duplicate window deleted: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
+    }
+    //Duplicates management
+    else if (mArrived_[slot] == IDframe)
+    {
+        EV << "VoIPReceiver::playout - Duplicated Packet: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
+    }
+    else if( last_jitter > 0.0 )
+    {
+        ++mPlayoutLoss_;
 
-        //Duplicates management
-        if (isArrived[pPacket->getIDframe()])
+        EV << "VoIPReceiver::playout - out of time packet deleted: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
+        emit(voIPJitterSignal_, last_jitter);
+    }
+    else
+    {
+        // remove the frames already played out
+        while (mPlayoutCount_ > 0 && pPacket->getArrivalTime() > mPlayoutRing_[mPlayoutHead_])
         {
-            EV << "VoIPReceiver::playout - Duplicated Packet: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
-            delete pPacket;
+            mPlayoutHead_ = (mPlayoutHead_ + 1) % mPlayoutRing_.size();
+            --mPlayoutCount_;
         }
-        else if( last_jitter > 0.0 )
+
+        if (mPlayoutCount_ < mPlayoutRing_.size())
         {
-            ++playoutLoss;
+            EV << "VoIPReceiver::playout - Sampleable packet inserted into buffer: TALK["<< pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe()
+               << "] - arrival time[" << pPacket->getArrivalTime() << "] -  sampling time[" << pPacket->getPlayoutTime() << "]\n";
 
-            EV << "VoIPReceiver::playout - out of time packet deleted: TALK[" << pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe() << "]\n";
-            emit(voIPJitterSignal_, last_jitter);
-            delete pPacket;
+            //duplicates management
+            mArrived_[slot] = IDframe;
+
+            mPlayoutRing_[(mPlayoutHead_ + mPlayoutCount_) % mPlayoutRing_.size()] = pPacket->getPlayoutTime();
+            ++mPlayoutCount_;
         }
         else
         {
-            while( !mPlayoutQueue_.empty() && pPacket->getArrivalTime() > mPlayoutQueue_.front()->getPlayoutTime() )
-            {
-                ++mBufferSpace_;
-                delete mPlayoutQueue_.front();
-                mPlayoutQueue_.pop_front();
-            }
-
-            if(mBufferSpace_ > 0)
-            {
-                EV << "VoIPReceiver::playout - Sampleable packet inserted into buffer: TALK["<< pPacket->getIDtalk() << "] - FRAME[" << pPacket->getIDframe()
-                   << "] - arrival time[" << pPacket->getArrivalTime() << "] -  sampling time[" << pPacket->getPlayoutTime() << "]\n";
-                --mBufferSpace_;
-
-                //duplicates management
-                isArrived[pPacket->getIDframe()] = true;
-
-                mPlayoutQueue_.push_back(pPacket);
-            }
-            else
-            {
-                ++tailDropLoss;
-                EV << "VoIPReceiver::playout - Buffer is full, discarding packet: TALK[" << pPacket->getIDtalk() << "] - FRAME["
-                   << pPacket->getIDframe() << "] - arrival time[" << pPacket->getArrivalTime() << "]\n";
-                delete pPacket;
-            }
+            ++mTailDropLoss_;
+            EV << "VoIPReceiver::playout - Buffer is full, discarding packet: TALK[" << pPacket->getIDtalk() << "] - FRAME["
+               << pPacket->getIDframe() << "] - arrival time[" << pPacket->getArrivalTime() << "]\n";
         }
-
-        mPacketsList_.pop_front();
     }
 
-    double proportionalLoss = ((double) tailDropLoss + (double) playoutLoss + (double) channelLoss) / (double) n_frames;
-    EV << "VoIPReceiver::playout - proportionalLoss " << proportionalLoss << "(tailDropLoss=" << tailDropLoss << " - playoutLoss="
-       <<  playoutLoss << " - channelLoss=" << channelLoss << ")\n\n";
+    delete pPacket;
+}
+
+void VoIPReceiver::playout(bool finish)
+{
+    if (mReceivedFrames_ == 0)
+        return;
+
+    double sample;
+
+    unsigned int n_frames = mTalkspurtFrames_;
+    unsigned int channelLoss;
+
+    if (finish)
+        channelLoss = mMaxFrameId_ + 1 - mReceivedFrames_;
+    else
+        channelLoss = n_frames - mReceivedFrames_;
+
+    sample = ((double) channelLoss / (double) n_frames);
+    emit(voIPFrameLossSignal_, sample);
+
+    double proportionalLoss = ((double) mTailDropLoss_ + (double) mPlayoutLoss_ + (double) channelLoss) / (double) n_frames;
+    EV << "VoIPReceiver::playout - proportionalLoss " << proportionalLoss << "(tailDropLoss=" << mTailDropLoss_ << " - playoutLoss="
+       <<  mPlayoutLoss_ << " - channelLoss=" << channelLoss << ")\n\n";
 
     double mos = eModel(mPlayoutDelay_, proportionalLoss);
 
 //    sample = SIMmPlayoutDelay_;
     emit(voIPPlayoutDelaySignal_, mPlayoutDelay_);
 
-    sample = ((double) playoutLoss / (double) n_frames);
+    sample = ((double) mPlayoutLoss_ / (double) n_frames);
     emit(voIPPlayoutLossSignal_, sample);
 
     sample = mos;
     emit(voIPMosSignal_, sample);
 
-    sample = ((double) tailDropLoss / (double) n_frames);
+    sample = ((double) mTailDropLoss_ / (double) n_frames);
     emit(voIPTaildropLossSignal_, sample);
 
-    EV << "VoIPReceiver::playout - Computed MOS: eModel( " << mPlayoutDelay_ << " , " << tailDropLoss << "+" << playoutLoss << "+"
+    EV << "VoIPReceiver::playout - Computed MOS: eModel( " << mPlayoutDelay_ << " , " << mTailDropLoss_ << "+" << mPlayoutLoss_ << "+"
        << channelLoss << " ) = " << mos << "\n";
 
     EV << "VoIPReceiver::playout - Playout Delay Adaptation \n" << "\t Old Playout Delay: " << mPlayoutDelay_ << "\n\t Max Jitter Measured: "
-       << max_jitter << "\n\n";
+       << mMaxJitter_ << "\n\n";
 
-    mPlayoutDelay_ += max_jitter;
+    mPlayoutDelay_ += mMaxJitter_;
     if (mPlayoutDelay_ < 0.0)
         mPlayoutDelay_ = 0.0;
     EV << "\t New Playout Delay: " << mPlayoutDelay_ << "\n\n";
 
-    delete[] isArrived;
+    mReceivedFrames_ = 0;
 }
 
 double VoIPReceiver::eModel(simtime_t delay, double loss)
@@ -16,7 +16,8 @@
 #include "L3AddressResolver.h"
 #include "UDPSocket.h"
 #include "VoipPacket_m.h"
-#include <list>
+#include <vector>
+#include <climits>
 
 class VoIPReceiver : public cSimpleModule
 {
@@ -29,14 +30,40 @@ class VoIPReceiver : public cSimpleModule
     int emodel_A_;
     double emodel_Ro_;
 
-    typedef std::list<VoipPacket*> PacketsList;
-    PacketsList mPacketsList_;
-    PacketsList mPlayoutQueue_;
     unsigned int mCurrentTalkspurt_;
-    unsigned int mBufferSpace_;
     simtime_t mSamplingDelta_;
     simtime_t mPlayoutDelay_;
 
+    /*
+     * Streaming playout state of the current talkspurt.
+     * Packets are evaluated as soon as they arrive, only
+     * per-talkspurt counters are kept until the talkspurt ends
+     */
+    simtime_t mFirstPlayoutTime_;
+    unsigned int mTalkspurtFrames_;
+    unsigned int mReceivedFrames_;
+    unsigned int mMaxFrameId_;
+    unsigned int mPlayoutLoss_;
+    unsigned int mTailDropLoss_;
+    simtime_t mMaxJitter_;
+
+    /*
+     * Window of frame ids used for duplicate detection: the slot of an
+     * accepted frame (id modulo the window size) holds its id, UINT_MAX
+     * if empty. The window covers ids from mArrivedBase_ on and follows
+     * the highest id received; older frames are discarded as late
+     */
+    std::vector<unsigned int> mArrived_;
+    unsigned int mArrivedBase_;
+
+    /*
+     * Playout buffer, as a FIFO ring of the playout times of the
+     * buffered frames. Its capacity is the buffer size (dim_buffer)
+     */
+    std::vector<simtime_t> mPlayoutRing_;
+    unsigned int mPlayoutHead_;
+    unsigned int mPlayoutCount_;
+
     bool mInit_;
 
     simsignal_t voIPFrameLossSignal_;
@@ -57,6 +84,12 @@ class VoIPReceiver : public cSimpleModule
     void initialize(int stage);
     void handleMessage(cMessage *msg);
     double eModel(simtime_t delay, double loss);
+
+    // starts a new talkspurt with the given (first received) packet
+    void startTalkspurt(VoipPacket* pPacket);
+    // evaluates a received packet against the playout buffer and deletes it
+    void playoutPacket(VoipPacket* pPacket);
+    // closes the current talkspurt, emitting its statistics
     void playout(bool finish);
 };
 
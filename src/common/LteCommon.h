@@ -68,6 +68,12 @@ class ExtCell;
 /// Max Number of Codewords
 #define MAX_CODEWORDS 2
 
+/// Logical connection id of the full-buffer connections generated by the eNB MAC
+#define FULL_BUFFER_LCID 0xFFFF
+
+/// Backlog (in bytes) reported by a full-buffer connection at each TTI
+#define FULL_BUFFER_BACKLOG 10000000
+
 // Number of QCI classes
 #define LTE_QCI_CLASSES 9
 
@@ -64,3 +64,11 @@ Coord UserControlInfo::getCoord() const
 {
     return senderCoord;
 }
+
+void UserControlInfo::reset()
+{
+    // operator= does not release the current parameters
+    setUserTxParams(NULL);
+    operator=(UserControlInfo());
+    feedbackReq = FeedbackRequest();
+}
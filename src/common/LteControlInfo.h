@@ -103,6 +103,12 @@ class UserControlInfo : public UserControlInfo_Base
     FeedbackRequest feedbackReq;
     void setCoord(const Coord& coord);
     Coord getCoord() const;
+
+    /**
+     * Restores the default values, so that the control info
+     * can travel again with a reused control message
+     */
+    void reset();
 };
 
 Register_Class(UserControlInfo);
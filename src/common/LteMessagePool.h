@@ -0,0 +1,85 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTEMESSAGEPOOL_H_
+#define _LTE_LTEMESSAGEPOOL_H_
+
+#include <vector>
+
+/**
+ * \class LteMessagePool
+ * \brief Free list of reusable control messages of a single type
+ *
+ * Control messages (grants, feedback, RAC and H-ARQ feedback) are sent
+ * at every TTI and live only until they are delivered. Instead of being
+ * deleted by the receiver, they are handed back to the module that
+ * produces them, which keeps them in a pool and resets them for the
+ * following transmissions.
+ *
+ * The pool does not handle ownership: the messages it holds must be
+ * owned by the module the pool belongs to (see cSimpleModule::take()).
+ * Messages keep their control info attached while pooled. At most
+ * "capacity" messages are kept, the extra ones are deleted.
+ */
+template<typename T>
+class LteMessagePool
+{
+    //! Free messages
+    std::vector<T*> free_;
+
+    //! Maximum number of free messages
+    unsigned int capacity_;
+
+  public:
+    //! Create an empty pool.
+    LteMessagePool(unsigned int capacity = 64)
+    {
+        capacity_ = capacity;
+    }
+    //! Delete the free messages.
+    ~LteMessagePool()
+    {
+        clear();
+    }
+
+    //! Return a free message, or NULL if the pool is empty.
+    T* get()
+    {
+        if (free_.empty())
+            return NULL;
+        T* msg = free_.back();
+        free_.pop_back();
+        return msg;
+    }
+
+    //! Give a delivered message back to the pool.
+    void put(T* msg)
+    {
+        if (free_.size() < capacity_)
+            free_.push_back(msg);
+        else
+            delete msg;
+    }
+
+    //! Delete all the free messages.
+    void clear()
+    {
+        for (unsigned int i = 0; i < free_.size(); i++)
+            delete free_[i];
+        free_.clear();
+    }
+
+    //! Number of free messages.
+    unsigned int size() const
+    {
+        return free_.size();
+    }
+};
+
+#endif
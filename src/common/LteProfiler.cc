@@ -0,0 +1,66 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include "LteProfiler.h"
+#include <sstream>
+
+const char* profiledStageToA(LteProfiledStage stage)
+{
+    switch (stage)
+    {
+        case PROF_HARQ_RX:
+            return "harqRx";
+        case PROF_SCHEDULE_UL:
+            return "scheduleUl";
+        case PROF_SCHEDULE_DL:
+            return "scheduleDl";
+        case PROF_PDU_MAKE:
+            return "macPduMake";
+        case PROF_HARQ_TX:
+            return "harqTx";
+        case PROF_SINR:
+            return "sinr";
+        case PROF_FEEDBACK:
+            return "feedback";
+        case PROF_RLC:
+            return "rlc";
+        default:
+            return "UNKNOWN_STAGE";
+    }
+}
+
+void LteProfiler::dump(cSimpleModule* module) const
+{
+    std::ostringstream summary;
+    summary << "TTI profile (cycles / calls / cycles per call):" << endl;
+
+    for (unsigned int cell = 0; cell < stats_.size(); ++cell)
+    {
+        if (stats_[cell].empty())
+            continue;
+
+        summary << "  cell " << cell << endl;
+        for (int stage = 0; stage < PROF_NUM_STAGES; ++stage)
+        {
+            const StageStats& s = stats_[cell][stage];
+            if (s.calls_ == 0)
+                continue;
+
+            const char* name = profiledStageToA((LteProfiledStage) stage);
+            summary << "    " << name << ": " << s.cycles_ << " / " << s.calls_ << " / " << s.cycles_ / s.calls_ << endl;
+
+            std::ostringstream scalar;
+            scalar << "profile:cell" << cell << ":" << name;
+            module->recordScalar((scalar.str() + ":cycles").c_str(), (double) s.cycles_);
+            module->recordScalar((scalar.str() + ":calls").c_str(), (double) s.calls_);
+        }
+    }
+    EV << summary.str();
+    std::cout << summary.str();
+}
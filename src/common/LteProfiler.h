@@ -0,0 +1,139 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTEPROFILER_H_
+#define _LTE_LTEPROFILER_H_
+
+#include "LteCommon.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#else
+#include <ctime>
+#endif
+
+/**
+ * Per-TTI processing stages accounted by the LteProfiler
+ */
+enum LteProfiledStage
+{
+    PROF_HARQ_RX = 0,   // extraction of the correctly received PDUs from the H-ARQ RX buffers
+    PROF_SCHEDULE_UL,   // uplink scheduling
+    PROF_SCHEDULE_DL,   // downlink scheduling
+    PROF_PDU_MAKE,      // MAC PDU construction
+    PROF_HARQ_TX,       // transmission of the selected H-ARQ processes
+    PROF_SINR,          // SINR computation in the channel model
+    PROF_FEEDBACK,      // channel feedback computation
+    PROF_RLC,           // RLC entity processing
+    PROF_NUM_STAGES
+};
+
+const char* profiledStageToA(LteProfiledStage stage);
+
+/**
+ * Accumulates, for each cell and processing stage, the number of times the
+ * stage has been executed and the CPU cycles spent in it.
+ *
+ * A single instance is owned by the binder, and it exists only when profiling
+ * has been enabled (LteBinder parameter profileTti): modules ask for it at
+ * initialization and, if they get NULL, skip any accounting.
+ * Cells are indexed by the MacNodeId of their eNB.
+ */
+class LteProfiler
+{
+  public:
+    typedef unsigned long long Cycles;
+
+    //! Reads the CPU cycle counter (or the best approximation available)
+    static Cycles now()
+    {
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+        return __rdtsc();
+#else
+        return (Cycles) clock();
+#endif
+    }
+
+    /**
+     * Accounts an execution of a stage
+     *
+     * @param cell id of the cell the stage has been executed for
+     * @param stage processing stage
+     * @param cycles cycles spent in the stage
+     */
+    void record(MacNodeId cell, LteProfiledStage stage, Cycles cycles)
+    {
+        if (cell >= stats_.size())
+            stats_.resize(cell + 1);
+        std::vector<StageStats>& cellStats = stats_[cell];
+        if (cellStats.empty())
+            cellStats.resize(PROF_NUM_STAGES);
+        cellStats[stage].cycles_ += cycles;
+        cellStats[stage].calls_++;
+    }
+
+    /**
+     * Prints a summary of the accounted stages and records it as scalars of the given module
+     *
+     * @param module module recording the scalars
+     */
+    void dump(cSimpleModule* module) const;
+
+  protected:
+    struct StageStats
+    {
+        Cycles cycles_;
+        unsigned long calls_;
+
+        StageStats()
+        {
+            cycles_ = 0;
+            calls_ = 0;
+        }
+    };
+
+    // accounted stages, indexed by cell id
+    std::vector<std::vector<StageStats> > stats_;
+};
+
+/**
+ * Accounts the execution of a stage from its construction to its destruction.
+ * It does nothing when built with a NULL profiler.
+ */
+class LteProfilerScope
+{
+    LteProfiler* profiler_;
+    MacNodeId cell_;
+    LteProfiledStage stage_;
+    LteProfiler::Cycles start_;
+
+  public:
+    LteProfilerScope(LteProfiler* profiler, MacNodeId cell, LteProfiledStage stage) :
+        profiler_(profiler), cell_(cell), stage_(stage), start_(0)
+    {
+        if (profiler_ != NULL)
+            start_ = LteProfiler::now();
+    }
+
+    ~LteProfilerScope()
+    {
+        if (profiler_ != NULL)
+            profiler_->record(cell_, stage_, LteProfiler::now() - start_);
+    }
+
+    //! Sets the cell the stage is accounted to, when it is known only while executing the stage
+    void setCell(MacNodeId cell)
+    {
+        cell_ = cell;
+    }
+};
+
+#endif
@@ -0,0 +1,126 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTEKPIFORMAT_H_
+#define _LTE_LTEKPIFORMAT_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+/**
+ * Definitions shared by the lteKpi result recorder and the
+ * standalone reader tool (tools/kpireader). This header must not
+ * depend on OMNeT++.
+ *
+ * File layout (all fixed-width integers are little endian):
+ *
+ *   header  : magic[8] | version (u32) | simtime scale exponent (i32)
+ *   chunk*  : stream id (u32) | rows (u32) | payload bytes (u32) | payload
+ *   index   : streams (u32) | { stream id (u32) | module (str) | name (str) }*
+ *             chunks (u32)  | { offset (u64) | stream id (u32) | rows (u32) |
+ *                               first time (i64) | last time (i64) }*
+ *   trailer : index offset (u64) | magic[8]
+ *
+ * where str is a u16 length followed by the characters.
+ *
+ * The chunk payload stores the three columns one after the other:
+ * - time  : raw simtime, delta from the previous row, zigzag varint
+ * - id    : delta from the previous row, zigzag varint
+ * - value : IEEE754 bits XORed with the previous row, varint
+ * Every chunk restarts the deltas from zero, so chunks can be
+ * decoded independently using the index.
+ */
+namespace LteKpi
+{
+
+const char MAGIC[8] = { 'L', 'T', 'E', 'K', 'P', 'I', '0', '1' };
+const uint32_t VERSION = 1;
+
+/// Rows buffered per stream before a chunk is written
+const unsigned int CHUNK_ROWS = 4096;
+
+/// Size of the fixed-width file header and trailer
+const unsigned int HEADER_SIZE = 16;
+const unsigned int TRAILER_SIZE = 16;
+
+inline void putFixed(std::string& buf, uint64_t v, unsigned int bytes)
+{
+    for (unsigned int i = 0; i < bytes; i++)
+        buf.push_back((char) ((v >> (8 * i)) & 0xff));
+}
+
+inline uint64_t getFixed(const unsigned char* p, unsigned int bytes)
+{
+    uint64_t v = 0;
+    for (unsigned int i = 0; i < bytes; i++)
+        v |= ((uint64_t) p[i]) << (8 * i);
+    return v;
+}
+
+inline void putString(std::string& buf, const std::string& s)
+{
+    putFixed(buf, s.size(), 2);
+    buf.append(s);
+}
+
+inline void putVarint(std::string& buf, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        buf.push_back((char) ((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    buf.push_back((char) v);
+}
+
+/**
+ * Decodes a varint at p, advancing it.
+ * Returns false if the buffer ends before the varint does
+ */
+inline bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& v)
+{
+    v = 0;
+    for (unsigned int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = *p++;
+        v |= ((uint64_t) (byte & 0x7f)) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t) v << 1) ^ (uint64_t) (v >> 63);
+}
+
+inline int64_t unzigzag(uint64_t v)
+{
+    return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+inline uint64_t doubleBits(double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+inline double bitsDouble(uint64_t bits)
+{
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+} // namespace LteKpi
+
+#endif
@@ -0,0 +1,221 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <errno.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+#include "LteKpiRecorder.h"
+
+Register_PerRunConfigOption(CFGID_LTE_KPI_FILE, "lte-kpi-file", CFG_FILENAME, "${resultdir}/${configname}-${runnumber}.kpi",
+    "Name of the binary columnar file written by the lteKpi result recorder");
+
+Register_ResultRecorder("lteKpi", LteKpiRecorder);
+
+/*
+ * LteKpiWriter member functions
+ */
+
+LteKpiWriter* LteKpiWriter::instance_ = NULL;
+unsigned int LteKpiWriter::refCount_ = 0;
+
+LteKpiWriter* LteKpiWriter::acquire()
+{
+    if (instance_ == NULL)
+        instance_ = new LteKpiWriter(getEnvir()->getConfig()->getAsFilename(CFGID_LTE_KPI_FILE));
+    refCount_++;
+    return instance_;
+}
+
+void LteKpiWriter::release()
+{
+    if (refCount_ == 0)
+        return;
+    if (--refCount_ == 0)
+    {
+        delete instance_;
+        instance_ = NULL;
+    }
+}
+
+static void makeParentDir(const std::string& fileName)
+{
+    // create the result directory if the vector/scalar managers did not yet
+    std::string::size_type pos = fileName.find_last_of("/\\");
+    if (pos == std::string::npos || pos == 0)
+        return;
+    std::string dir = fileName.substr(0, pos);
+#ifdef _WIN32
+    _mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+}
+
+LteKpiWriter::LteKpiWriter(const std::string& fileName)
+{
+    fileName_ = fileName;
+    makeParentDir(fileName_);
+    file_ = fopen(fileName_.c_str(), "wb");
+    if (file_ == NULL)
+        throw cRuntimeError("LteKpiWriter: cannot open KPI file '%s': %s", fileName_.c_str(), strerror(errno));
+
+    buffer_.clear();
+    buffer_.append(LteKpi::MAGIC, sizeof(LteKpi::MAGIC));
+    LteKpi::putFixed(buffer_, LteKpi::VERSION, 4);
+    LteKpi::putFixed(buffer_, (uint32_t) SimTime::getScaleExp(), 4);
+    fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    offset_ = buffer_.size();
+}
+
+LteKpiWriter::~LteKpiWriter()
+{
+    writeIndex();
+    fclose(file_);
+}
+
+unsigned int LteKpiWriter::registerStream(const std::string& module, const std::string& name)
+{
+    StreamEntry entry;
+    entry.module_ = module;
+    entry.name_ = name;
+    streams_.push_back(entry);
+    return streams_.size() - 1;
+}
+
+void LteKpiWriter::writeChunk(unsigned int stream, const std::vector<int64_t>& times,
+    const std::vector<unsigned int>& ids, const std::vector<double>& values)
+{
+    unsigned int rows = times.size();
+    if (rows == 0)
+        return;
+
+    // encode the three columns one after the other
+    buffer_.clear();
+    int64_t prevTime = 0;
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        LteKpi::putVarint(buffer_, LteKpi::zigzag(times[i] - prevTime));
+        prevTime = times[i];
+    }
+    int64_t prevId = 0;
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        LteKpi::putVarint(buffer_, LteKpi::zigzag((int64_t) ids[i] - prevId));
+        prevId = ids[i];
+    }
+    uint64_t prevBits = 0;
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        uint64_t bits = LteKpi::doubleBits(values[i]);
+        LteKpi::putVarint(buffer_, bits ^ prevBits);
+        prevBits = bits;
+    }
+
+    std::string header;
+    LteKpi::putFixed(header, stream, 4);
+    LteKpi::putFixed(header, rows, 4);
+    LteKpi::putFixed(header, buffer_.size(), 4);
+
+    ChunkEntry entry;
+    entry.offset_ = offset_;
+    entry.stream_ = stream;
+    entry.rows_ = rows;
+    entry.firstTime_ = times.front();
+    entry.lastTime_ = times.back();
+    chunks_.push_back(entry);
+
+    fwrite(header.data(), 1, header.size(), file_);
+    fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    offset_ += header.size() + buffer_.size();
+}
+
+void LteKpiWriter::writeIndex()
+{
+    buffer_.clear();
+    LteKpi::putFixed(buffer_, streams_.size(), 4);
+    for (unsigned int i = 0; i < streams_.size(); i++)
+    {
+        LteKpi::putFixed(buffer_, i, 4);
+        LteKpi::putString(buffer_, streams_[i].module_);
+        LteKpi::putString(buffer_, streams_[i].name_);
+    }
+    LteKpi::putFixed(buffer_, chunks_.size(), 4);
+    std::vector<ChunkEntry>::iterator it;
+    for (it = chunks_.begin(); it != chunks_.end(); ++it)
+    {
+        LteKpi::putFixed(buffer_, it->offset_, 8);
+        LteKpi::putFixed(buffer_, it->stream_, 4);
+        LteKpi::putFixed(buffer_, it->rows_, 4);
+        LteKpi::putFixed(buffer_, (uint64_t) it->firstTime_, 8);
+        LteKpi::putFixed(buffer_, (uint64_t) it->lastTime_, 8);
+    }
+    LteKpi::putFixed(buffer_, offset_, 8);
+    buffer_.append(LteKpi::MAGIC, sizeof(LteKpi::MAGIC));
+    fwrite(buffer_.data(), 1, buffer_.size(), file_);
+}
+
+/*
+ * LteKpiRecorder member functions
+ */
+
+LteKpiRecorder::~LteKpiRecorder()
+{
+    // the module may be deleted before finish() (e.g. a UE leaving the simulation)
+    if (writer_ != NULL)
+    {
+        flush();
+        writer_ = NULL;
+        LteKpiWriter::release();
+    }
+}
+
+void LteKpiRecorder::subscribedTo(cResultFilter *prev)
+{
+    cNumericResultRecorder::subscribedTo(prev);
+
+    writer_ = LteKpiWriter::acquire();
+    stream_ = writer_->registerStream(getComponent()->getFullPath(), getResultName());
+
+    times_.reserve(LteKpi::CHUNK_ROWS);
+    ids_.reserve(LteKpi::CHUNK_ROWS);
+    values_.reserve(LteKpi::CHUNK_ROWS);
+}
+
+void LteKpiRecorder::collect(simtime_t t, double value, unsigned int id, cComponent* module)
+{
+    if (writer_ == NULL)
+        return;
+
+    times_.push_back(t.raw());
+    ids_.push_back(id);
+    values_.push_back(value);
+
+    if (times_.size() >= LteKpi::CHUNK_ROWS)
+        flush();
+}
+
+void LteKpiRecorder::flush()
+{
+    writer_->writeChunk(stream_, times_, ids_, values_);
+    times_.clear();
+    ids_.clear();
+    values_.clear();
+}
+
+void LteKpiRecorder::finish(cResultFilter *prev)
+{
+    if (writer_ == NULL)
+        return;
+
+    flush();
+    writer_ = NULL;
+    LteKpiWriter::release();
+}
@@ -0,0 +1,150 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTEKPIRECORDER_H_
+#define _LTE_LTEKPIRECORDER_H_
+
+#include <stdio.h>
+#include <vector>
+#include "lterecorder.h"
+#include "LteKpiFormat.h"
+
+/**
+ * \class LteKpiWriter
+ * \brief Process-wide writer of the binary columnar KPI file
+ *
+ * All lteKpi recorders of a run share one writer: each recorder
+ * registers a stream (module path, statistic name) and hands over
+ * full chunks of rows. The index is written when the last recorder
+ * releases the writer. See LteKpiFormat.h for the file layout.
+ */
+class LteKpiWriter
+{
+  public:
+    /**
+     * Returns the writer of the current run, opening the
+     * file on first use
+     */
+    static LteKpiWriter* acquire();
+
+    /**
+     * Drops a reference to the writer. The last
+     * release writes the index and closes the file
+     */
+    static void release();
+
+    /**
+     * Registers a new stream and returns its identifier
+     *
+     * @param module Full path of the recording module
+     * @param name Statistic name
+     */
+    unsigned int registerStream(const std::string& module, const std::string& name);
+
+    /**
+     * Encodes and writes one chunk of rows for the given stream
+     */
+    void writeChunk(unsigned int stream, const std::vector<int64_t>& times,
+        const std::vector<unsigned int>& ids, const std::vector<double>& values);
+
+  private:
+    LteKpiWriter(const std::string& fileName);
+    ~LteKpiWriter();
+
+    /// Writes the index and the trailer
+    void writeIndex();
+
+    struct ChunkEntry
+    {
+        uint64_t offset_;
+        unsigned int stream_;
+        unsigned int rows_;
+        int64_t firstTime_;
+        int64_t lastTime_;
+    };
+
+    struct StreamEntry
+    {
+        std::string module_;
+        std::string name_;
+    };
+
+    static LteKpiWriter* instance_;
+    static unsigned int refCount_;
+
+    FILE* file_;
+    std::string fileName_;
+    uint64_t offset_;
+    std::vector<StreamEntry> streams_;
+    std::vector<ChunkEntry> chunks_;
+
+    /// Encoding buffer, reused across chunks
+    std::string buffer_;
+};
+
+/**
+ * \class LteKpiRecorder
+ * \brief Records tagged samples to the binary columnar KPI file
+ *
+ * This recorder is an optional alternative to lteVector: instead of
+ * one output vector per (statistic, id) pair it stores all samples of
+ * a statistic as (time, id, value) rows, written in compressed chunks
+ * to the file given by the "lte-kpi-file" configuration option.
+ * Enable it with e.g. **.result-recording-modes = +lteKpi
+ */
+class LteKpiRecorder : public LteRecorder
+{
+  public:
+    LteKpiRecorder()
+    {
+        writer_ = NULL;
+        stream_ = 0;
+    }
+    virtual ~LteKpiRecorder();
+
+    /**
+     * subscribedTo() opens the shared writer and registers
+     * the stream for this statistic
+     *
+     * @param prev Filter used for this signal
+     */
+    virtual void subscribedTo(cResultFilter *prev);
+
+    /**
+     * finish() writes the last (partial) chunk
+     * and releases the shared writer
+     *
+     * @param prev Filter used for this signal
+     */
+    virtual void finish(cResultFilter *prev);
+
+  protected:
+    /**
+     * collect() appends the sample to the column buffers,
+     * writing a chunk when they are full
+     *
+     * @param t Reference to simulation time event occurred
+     * @param value Sample received
+     * @param id Id specified by the caller
+     */
+    virtual void collect(simtime_t t, double value, unsigned int id, cComponent* module);
+
+    /// Writes the buffered rows as a chunk
+    void flush();
+
+  private:
+    LteKpiWriter* writer_;
+    unsigned int stream_;
+
+    std::vector<int64_t> times_;
+    std::vector<unsigned int> ids_;
+    std::vector<double> values_;
+};
+
+#endif
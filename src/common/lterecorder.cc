@@ -28,9 +28,9 @@ Register_ResultRecorder("lteRate", LteRateRecorder);
 LteStatisticsRecorder::~LteStatisticsRecorder()
 {
     // Delete all stored cStatistic objects
-    std::map<unsigned int, cStatistic*>::iterator it;
+    std::vector<cStatistic*>::iterator it;
     for (it = stats_.begin(); it != stats_.end(); it++)
-        delete it->second;
+        delete *it;
     stats_.clear();
 }
 
@@ -38,17 +38,18 @@ void LteStatisticsRecorder::finish(cResultFilter *prev)
 {
     opp_string_map attributes = getStatisticAttributes();
     //char metricName[50];
-    std::map<unsigned int, cStatistic*>::iterator it;
-    for (it = stats_.begin(); it != stats_.end(); it++)
+    for (unsigned int i = 0; i < stats_.size(); i++)
     {
+        if (stats_[i] == NULL || !isRegistered(i))
+            continue;
         // UE might have left the simulation, in this case,
         // finish has already been called
-        int id = getBinder()->getOmnetId(it->first);
+        int id = getBinder()->getOmnetId(i);
         if(id == 0){
                 continue;
         }
         // Record metrics for all IDs
-        getEnvir()->recordStatistic(moduleMap_[it->first], /*metricName*/ getResultName().c_str(), it->second, &attributes);
+        getEnvir()->recordStatistic(moduleMap_[i], /*metricName*/ getResultName().c_str(), stats_[i], &attributes);
     }
 }
 
@@ -62,11 +63,13 @@ void LteStatsRecorder::subscribedTo(cResultFilter *prev)
 
 void LteStatsRecorder::collect(simtime_t t, double value, unsigned int id, cComponent* module)
 {
-    if (!stats_[id])
-        stats_[id] = new cStdDev();
-    stats_[id]->collect(value);    // Local Recording
+    if (!isRegistered(id))
+        registerId(id, module);
 
-    moduleMap_[id] = module;
+    cStatistic*& stat = getSlot(id);
+    if (!stat)
+        stat = new cStdDev();
+    stat->collect(value);    // Local Recording
 }
 
 /*
@@ -75,15 +78,18 @@ void LteStatsRecorder::collect(simtime_t t, double value, unsigned int id, cComp
 
 void LteHistogramRecorder::subscribedTo(cResultFilter *prev)
 {
-    stats_[0] = new cHistogram();
+    getSlot(0) = new cHistogram();
 }
 
 void LteHistogramRecorder::collect(simtime_t t, double value, unsigned int id, cComponent* module)
 {
-    if (!stats_[id])
-        stats_[id] = new cHistogram();
-    stats_[id]->collect(value);    // Local Recording
-    moduleMap_[id] = module;
+    if (!isRegistered(id))
+        registerId(id, module);
+
+    cStatistic*& stat = getSlot(id);
+    if (!stat)
+        stat = new cHistogram();
+    stat->collect(value);    // Local Recording
 }
 
 /*
@@ -98,12 +104,28 @@ void LteVectorRecorder::subscribedTo(cResultFilter *prev)
     opp_string_map attributes = getStatisticAttributes();
 
     // register global vector handle
+    handle_.resize(1, NULL);
     handle_[0] = getEnvir()->registerOutputVector(getComponent()->getFullPath().c_str(), getResultName().c_str());
     ASSERT(handle_[0] != NULL);
     for (opp_string_map::iterator it = attributes.begin(); it != attributes.end(); ++it)
         getEnvir()->setVectorAttribute(handle_[0], it->first.c_str(), it->second.c_str());
     }
 
+void LteVectorRecorder::registerVector(unsigned int id)
+{
+    // register vector handle for new id
+    opp_string_map attributes = getStatisticAttributes();
+    char metricName[50];
+    snprintf(metricName, sizeof(metricName), "%s:id=%d", getResultName().c_str(), id);
+
+    if (id >= handle_.size())
+        handle_.resize(id + 1, NULL);
+    handle_[id] = getEnvir()->registerOutputVector(moduleMap_[id]->getFullPath().c_str(), metricName);
+    ASSERT(handle_[id] != NULL);
+    for (opp_string_map::iterator it = attributes.begin(); it != attributes.end(); ++it)
+        getEnvir()->setVectorAttribute(handle_[id], it->first.c_str(), it->second.c_str());
+}
+
 void LteVectorRecorder::collect(simtime_t t, double value, unsigned int id, cComponent* module)
 {
     if (t < lastTime_)
@@ -113,23 +135,33 @@ void LteVectorRecorder::collect(simtime_t t, double value, unsigned int id, cCom
             cResultListener::getClassName(), SIMTIME_STR(t), SIMTIME_STR(lastTime_));
     }
 
-    moduleMap_[id] = module;
-
     lastTime_ = t;
-    if (!handle_[id])
-    {
-        // register vector handle for new id
-        opp_string_map attributes = getStatisticAttributes();
-        char metricName[50];
-        sprintf(metricName, "%s:id=%d", getResultName().c_str(), id);
-
-        handle_[id] = getEnvir()->registerOutputVector(moduleMap_[id]->getFullPath().c_str(), metricName);
-        ASSERT(handle_[id] != NULL);
-        for (opp_string_map::iterator it = attributes.begin(); it != attributes.end(); ++it)
-            getEnvir()->setVectorAttribute(handle_[id], it->first.c_str(), it->second.c_str());
-        }
+    if (!isRegistered(id))
+        registerId(id, module);
+    if (id >= handle_.size() || !handle_[id])
+        registerVector(id);
+
+    PendingSample sample;
+    sample.handle_ = handle_[id];
+    sample.time_ = t;
+    sample.value_ = value;
+    pending_.push_back(sample);        // Local Recording
+
+    if (pending_.size() >= VECTOR_BATCH_SIZE)
+        flush();
+}
 
-    getEnvir()->recordInOutputVector(handle_[id], t, value);        // Local Recording
+void LteVectorRecorder::flush()
+{
+    std::vector<PendingSample>::iterator it;
+    for (it = pending_.begin(); it != pending_.end(); ++it)
+        getEnvir()->recordInOutputVector(it->handle_, it->time_, it->value_);
+    pending_.clear();
+}
+
+void LteVectorRecorder::finish(cResultFilter *prev)
+{
+    flush();
 }
 
 /*
@@ -138,9 +170,14 @@ void LteVectorRecorder::collect(simtime_t t, double value, unsigned int id, cCom
 
 void LteAvgRecorder::collect(simtime_t t, double value, unsigned int id, cComponent* module)
 {
+    if (!isRegistered(id))
+    {
+        registerId(id, module);
+        if (id >= vals_.size())
+            vals_.resize(id + 1);
+    }
     vals_[id].count_++;
     vals_[id].sum_ += value;
-    moduleMap_[id] = module;
 }
 
 void LteAvgRecorder::finish(cResultFilter *prev)
@@ -148,18 +185,19 @@ void LteAvgRecorder::finish(cResultFilter *prev)
     opp_string_map attributes = getStatisticAttributes();
     //char metricName[50];
     double totalSum = 0;        // Global numbers
-    std::map<unsigned int, recordedValues_>::iterator it;
-    for (it = vals_.begin(); it != vals_.end(); it++)
+    for (unsigned int i = 0; i < vals_.size(); i++)
     {
+        if (vals_[i].count_ == 0 || !isRegistered(i))
+            continue;
         // Record metrics for all IDs
-        int id = getBinder()->getOmnetId(it->first);
+        int id = getBinder()->getOmnetId(i);
         if(id == 0){
                 // UE had left the simulation before
                 continue;
         }
-        totalSum += (it->second.sum_ / it->second.count_);
-        getEnvir()->recordScalar(moduleMap_[it->first], getResultName().c_str(),
-            it->second.sum_/it->second.count_, &attributes);
+        totalSum += (vals_[i].sum_ / vals_[i].count_);
+        getEnvir()->recordScalar(moduleMap_[i], getResultName().c_str(),
+            vals_[i].sum_/vals_[i].count_, &attributes);
     }
 }
 
@@ -169,13 +207,17 @@ void LteAvgRecorder::finish(cResultFilter *prev)
 
 void LteRateRecorder::collect(simtime_t t, double value, unsigned int id, cComponent* module)
 {
+    if (!isRegistered(id))
+    {
+        registerId(id, module);
+        if (id >= vals_.size())
+            vals_.resize(id + 1);
+    }
     if (vals_[id].startTime_ == 0)
     {
         vals_[id].startTime_ = t;
     }
     vals_[id].sum_ += value;
-
-    moduleMap_[id] = module;
 }
 
 void LteRateRecorder::finish(cResultFilter *prev)
@@ -183,19 +225,20 @@ void LteRateRecorder::finish(cResultFilter *prev)
     opp_string_map attributes = getStatisticAttributes();
     double interval, totalSum = 0;        // Global numbers
 
-    std::map<unsigned int, recordedValues_>::iterator it;
-    for (it = vals_.begin(); it != vals_.end(); it++)
+    for (unsigned int i = 0; i < vals_.size(); i++)
     {
-        interval = (simTime() - it->second.startTime_).dbl();
-        totalSum += it->second.sum_ / interval;
+        if (!isRegistered(i))
+            continue;
 
-        int id = getBinder()->getOmnetId(it->first);
+        interval = (simTime() - vals_[i].startTime_).dbl();
+        totalSum += vals_[i].sum_ / interval;
+
+        int id = getBinder()->getOmnetId(i);
         if(id == 0){
                 // UE had left the simulation before - skip it
                 continue;
         }
-        getEnvir()->recordScalar(moduleMap_[it->first], getResultName().c_str(),
-            it->second.sum_/interval, &attributes);
+        getEnvir()->recordScalar(moduleMap_[i], getResultName().c_str(),
+            vals_[i].sum_/interval, &attributes);
     }
 }
-
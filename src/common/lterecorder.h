@@ -11,7 +11,7 @@
 #define _LTE_LTERECORDERS_H_
 
 #include <omnetpp.h>
-#include <map>
+#include <vector>
 
 using namespace omnetpp;
 
@@ -43,8 +43,13 @@ class LteRecorder : public cNumericResultRecorder, private cObject
 {
   protected:
 
-    // Map associating each metric ID with its emitting module
-    std::map<unsigned int, cComponent*> moduleMap_;
+    /*
+     * Dense table associating each metric ID with its emitting module.
+     * IDs are MacNodeIds (small integers), so the table is indexed
+     * directly by ID and grows on demand. A NULL entry means the ID
+     * has not been registered (yet).
+     */
+    std::vector<cComponent*> moduleMap_;
 
   public:
     LteRecorder()
@@ -75,11 +80,38 @@ class LteRecorder : public cNumericResultRecorder, private cObject
     }
 
     void deleteModule(unsigned int nodeId){
-        moduleMap_.erase(nodeId);
+        if (nodeId < moduleMap_.size())
+            moduleMap_[nodeId] = NULL;
     }
 
   protected:
 
+    /**
+     * isRegistered() tells whether the given id has already
+     * been associated to its emitting module
+     *
+     * @param id Id specified by the caller
+     */
+    bool isRegistered(unsigned int id) const
+    {
+        return id < moduleMap_.size() && moduleMap_[id] != NULL;
+    }
+
+    /**
+     * registerId() associates the given id with its emitting module,
+     * growing the dense table if needed. It is called once per id,
+     * the first time a sample for that id is collected
+     *
+     * @param id Id specified by the caller
+     * @param module Emitting module
+     */
+    void registerId(unsigned int id, cComponent* module)
+    {
+        if (id >= moduleMap_.size())
+            moduleMap_.resize(id + 1, NULL);
+        moduleMap_[id] = module;
+    }
+
     /**
      * collect() is virtual in NumericResultRecorder, does nothing
      *
@@ -151,10 +183,23 @@ class LteStatisticsRecorder : public LteRecorder
 
   protected:
     /**
-     * Map associating each id with a
-     * cStatistic object
+     * Dense table associating each id with a
+     * cStatistic object (NULL if not created yet)
+     */
+    std::vector<cStatistic*> stats_;
+
+    /**
+     * getSlot() returns the cStatistic slot for the given id,
+     * growing the dense table if needed
+     *
+     * @param id Id specified by the caller
      */
-    std::map<unsigned int, cStatistic*> stats_;
+    cStatistic*& getSlot(unsigned int id)
+    {
+        if (id >= stats_.size())
+            stats_.resize(id + 1, NULL);
+        return stats_[id];
+    }
 };
 
 /**
@@ -246,12 +291,21 @@ class LteVectorRecorder : public LteRecorder
     LteVectorRecorder()
     {
         lastTime_ = 0;
+        pending_.reserve(VECTOR_BATCH_SIZE);
     }
     virtual ~LteVectorRecorder()
     {
         handle_.clear();
     }
 
+    /**
+     * finish() writes the samples still pending
+     * in the batch to the output vectors
+     *
+     * @param prev Filter used for this signal
+     */
+    virtual void finish(cResultFilter *prev);
+
     /**
      * subscibeTo() registers a new output
      * vector inside handle_[0]
@@ -264,10 +318,11 @@ class LteVectorRecorder : public LteRecorder
     /**
      * collect() performs the following tasks:
      * - Verify that the samples ordering is correct
-     * - If there is not an handle for current is, registers
+     * - If there is not an handle for current id, registers
      *   a new output vector and associates the handle to it
-     * - Record the sample to the output vector for this id
-     *   and for the "global" statistic
+     *   (this happens only once per id)
+     * - Append the sample to the pending batch, which is
+     *   written to the output vectors when full
      *
      * @param t Reference to simulation time event occurred
      * @param value Sample received
@@ -275,16 +330,46 @@ class LteVectorRecorder : public LteRecorder
      */
     virtual void collect(simtime_t t, double value, unsigned int id, cComponent* module);
 
+    /**
+     * registerVector() registers the output vector for a new id
+     *
+     * @param id Id specified by the caller
+     */
+    void registerVector(unsigned int id);
+
+    /**
+     * flush() writes all pending samples to the
+     * output vector manager, in collection order
+     */
+    void flush();
+
   private:
+    /// Number of samples buffered before writing them to the output vectors
+    static const unsigned int VECTOR_BATCH_SIZE = 256;
+
+    /**
+     * \struct PendingSample
+     * \brief sample waiting to be written to its output vector
+     */
+    struct PendingSample
+    {
+        void* handle_;
+        simtime_t time_;
+        double value_;
+    };
+
     /// This variable is used to ensure increasing timestamp order
     simtime_t lastTime_;
 
     /**
-     * This map associated each id with an handle
+     * Dense table associating each id with an handle
      * who identifies the output vector for the
-     * output vector manager
+     * output vector manager (NULL if not registered yet)
      */
-    std::map<unsigned int, void*> handle_;
+    std::vector<void*> handle_;
+
+    /// Samples collected but not yet written to the output vectors
+    std::vector<PendingSample> pending_;
 };
 
 /**
@@ -316,13 +401,20 @@ class LteAvgRecorder : public LteRecorder
     {
         unsigned int count_;
         double sum_;
+
+    public:
+        recordedValues_()
+        {
+            count_ = 0;
+            sum_ = 0;
+        }
     };
 
     /**
-     * Map associating each id with a
+     * Dense table associating each id with a
      * recorded values structure
      */
-    std::map<unsigned int, recordedValues_> vals_;
+    std::vector<recordedValues_> vals_;
 
   protected:
     /**
@@ -398,10 +490,10 @@ class LteRateRecorder : public LteRecorder
     };
 
     /**
-     * Map associating each id with a
+     * Dense table associating each id with a
      * recorded values structure
      */
-    std::map<unsigned int, recordedValues_> vals_;
+    std::vector<recordedValues_> vals_;
 
   protected:
     /**
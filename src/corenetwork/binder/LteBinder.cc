@@ -634,6 +634,8 @@ void LteBinder::unregisterNode(MacNodeId id){
     std::map<IPv4Address, MacNodeId>::iterator it;
     for(it = macNodeIdToIPAddress_.begin(); it != macNodeIdToIPAddress_.end(); ){
         if(it->second == id){
+            forwardingTable_.erase(it->first);
+            forwardingVersion_++;
             macNodeIdToIPAddress_.erase(it++);
         } else {
                 it++;
@@ -697,6 +699,21 @@ void LteBinder::registerNextHop(MacNodeId masterId, MacNodeId slaveId)
     if (nextHop_.size() <= slaveId)
         nextHop_.resize(slaveId + 1);
     nextHop_[slaveId] = masterId;
+    updateForwardingTable(slaveId);
+}
+
+void LteBinder::updateForwardingTable(MacNodeId slaveId)
+{
+    // handovers are rare events: a linear scan of the addresses is fine here
+    std::map<IPv4Address, MacNodeId>::iterator it = macNodeIdToIPAddress_.begin();
+    for (; it != macNodeIdToIPAddress_.end(); ++it)
+    {
+        if (it->second == slaveId)
+        {
+            forwardingTable_[it->first] = nextHop_[slaveId];
+            forwardingVersion_++;
+        }
+    }
 }
 
 void LteBinder::initialize(int stage)
@@ -745,6 +762,21 @@ void LteBinder::initialize(int stage)
     }
 }
 
+void LteBinder::finish()
+{
+    if (profiler_ != NULL)
+        profiler_->dump(this);
+}
+
+LteProfiler* LteBinder::getProfiler()
+{
+    // parameters are available before initialization, so modules may call
+    // this method at any stage, regardless of the initialization order
+    if (profiler_ == NULL && par("profileTti").boolValue())
+        profiler_ = new LteProfiler();
+    return profiler_;
+}
+
 std::string LteBinder::increment_address(const char* address_string)  //TODO unused function
 {
     IPv4Address addr(address_string);
@@ -776,6 +808,7 @@ void LteBinder::unregisterNextHop(MacNodeId masterId, MacNodeId slaveId)
     if (nextHop_.size() <= slaveId)
         return;
     nextHop_[slaveId] = 0;
+    updateForwardingTable(slaveId);
 }
 
 OmnetId LteBinder::getOmnetId(MacNodeId nodeId)
@@ -873,6 +906,7 @@ void LteBinder::addD2DCapability(MacNodeId src, MacNodeId dst)
         throw cRuntimeError("LteBinder::addD2DCapability - Node Id not valid. Src %d Dst %d", src, dst);
 
     d2dPeeringCapability_[src][dst] = true;
+    d2dPeers_[src].insert(dst);
 
     // insert initial communication mode
     // TODO make it configurable from NED
@@ -889,6 +923,14 @@ bool LteBinder::checkD2DCapability(MacNodeId src, MacNodeId dst)
     return d2dPeeringCapability_[src][dst];
 }
 
+const std::set<MacNodeId>* LteBinder::getD2DPeers(MacNodeId src)
+{
+    std::map<MacNodeId, std::set<MacNodeId> >::iterator it = d2dPeers_.find(src);
+    if (it == d2dPeers_.end())
+        return NULL;
+    return &(it->second);
+}
+
 std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> >* LteBinder::getD2DPeeringModeMap()
 {
     return &d2dPeeringMode_;
@@ -914,6 +956,7 @@ void LteBinder::registerMulticastGroup(MacNodeId nodeId, int32 groupId)
     {
         multicastGroupMap_[nodeId].insert(groupId);
     }
+    multicastGroupMembers_[groupId].insert(nodeId);
 }
 
 bool LteBinder::isInMulticastGroup(MacNodeId nodeId, int32 groupId)
@@ -926,6 +969,14 @@ bool LteBinder::isInMulticastGroup(MacNodeId nodeId, int32 groupId)
     return true;
 }
 
+const std::set<MacNodeId>* LteBinder::getMulticastGroupMembers(int32 groupId)
+{
+    std::map<int32, std::set<MacNodeId> >::iterator it = multicastGroupMembers_.find(groupId);
+    if (it == multicastGroupMembers_.end())
+        return NULL;
+    return &(it->second);
+}
+
 void LteBinder::updateUeInfoCellId(MacNodeId id, MacCellId newCellId)
 {
     std::vector<UeInfo*>::iterator it = ueList_.begin();
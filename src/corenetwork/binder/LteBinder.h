@@ -17,6 +17,7 @@
 #include "L3Address.h"
 #include "PhyPisaData.h"
 #include "ExtCell.h"
+#include "LteProfiler.h"
 
 using namespace inet;
 
@@ -33,6 +34,8 @@ using namespace inet;
  * - nextHop, binding each master node id with its slave
  * - nodeId, binding each node id with the module id used by Omnet.
  * - dMap_, binding each master with all its slaves (used by amc)
+ * - forwardingTable_, binding each IP address with the next hop towards it,
+ *   kept in sync with nextHop on attach and handover
  *
  * The binder is accessed to gather:
  * - the nextHop table (by the eNodeB)
@@ -51,6 +54,8 @@ class LteBinder : public cSimpleModule
     std::map<MacNodeId, char*> macNodeIdToModuleName_;
     DeployerList deployersMap_;
     std::vector<MacNodeId> nextHop_; // MacNodeIdMaster --> MacNodeIdSlave
+    std::map<IPv4Address, MacNodeId> forwardingTable_; // IP address --> next hop MacNodeId
+    unsigned int forwardingVersion_; // incremented at each change of forwardingTable_
     std::map<int, OmnetId> nodeIds_;
 
     // list of static external cells. Used for intercell interference evaluation
@@ -61,6 +66,8 @@ class LteBinder : public cSimpleModule
 
     // list of all UEs. Used for inter-cell interference evaluation
     std::vector<UeInfo*> ueList_;
+    // UeInfo indexed by the UE MacNodeId
+    std::map<MacNodeId, UeInfo*> ueInfoMap_;
 
     MacNodeId macNodeIdCounter_[3]; // MacNodeId Counter
     DeployedUesMap dMap_; // DeployedUes --> Master Mapping
@@ -70,6 +77,12 @@ class LteBinder : public cSimpleModule
 
     std::string increment_address(const char* address_string); //TODO unused function
 
+    /*
+     * Updates the next hop of the addresses of the given node
+     * after a change of its entry in the nextHop table
+     */
+    void updateForwardingTable(MacNodeId slaveId);
+
     /*
      * X2 Support
      */
@@ -85,6 +98,8 @@ class LteBinder : public cSimpleModule
     bool **d2dPeeringCapability_;
     // determines if two D2D-capable UEs are communicating in D2D mode or Infrastructure Mode
     std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> > d2dPeeringMode_;
+    // for each UE, the set of UEs it may communicate with using D2D
+    std::map<MacNodeId, std::set<MacNodeId> > d2dPeers_;
 
     /*
      * Multicast support
@@ -92,15 +107,25 @@ class LteBinder : public cSimpleModule
     // register here the IDs of the multicast group where UEs participate
     typedef std::set<uint32> MulticastGroupIdSet;
     std::map<MacNodeId, MulticastGroupIdSet> multicastGroupMap_;
+    // for each multicast group, the IDs of the nodes enrolled in it
+    std::map<int32, std::set<MacNodeId> > multicastGroupMembers_;
 
     /*
      * Handover support
      */
     // store the id of the UEs that are performing handover
     std::set<MacNodeId> ueHandoverTriggered_;
+
+    /*
+     * Profiling support
+     */
+    // per-TTI stages profiler, NULL if profiling is disabled
+    LteProfiler* profiler_;
   protected:
     virtual void initialize(int stages);
 
+    virtual void finish();
+
     virtual int numInitStages() const { return INITSTAGE_LAST; }
 
     virtual void handleMessage(cMessage *msg)
@@ -147,6 +172,8 @@ class LteBinder : public cSimpleModule
         macNodeIdCounter_[0] = ENB_MIN_ID;
         macNodeIdCounter_[1] = RELAY_MIN_ID;
         macNodeIdCounter_[2] = UE_MIN_ID;
+        forwardingVersion_ = 0;
+        profiler_ = NULL;
     }
 
     void registerDeployer(LteDeployer* pDeployer, MacCellId macCellId);
@@ -158,7 +185,16 @@ class LteBinder : public cSimpleModule
             delete enbList_.back();
             enbList_.pop_back();
         }
+        delete profiler_;
     }
+    /**
+     * Returns the profiler of the per-TTI processing stages.
+     * It can be called at any initialization stage.
+     *
+     * @return the profiler, or NULL if profiling is disabled
+     */
+    LteProfiler* getProfiler();
+
     int getQCIPriority(int);
     double getPacketDelayBudget(int);
     double getPacketErrorLossRate(int);
@@ -232,6 +268,32 @@ class LteBinder : public cSimpleModule
      */
     MacNodeId getNextHop(MacNodeId slaveId);
 
+    /**
+     * Returns the next hop (eNB or relay) towards the given IP address.
+     * The table is updated on attach and handover only, so that this
+     * lookup can be done on a per-packet basis.
+     *
+     * @param address IP address of the destination
+     * @return MacNodeId of the next hop, 0 if the address is unknown
+     */
+    MacNodeId getNextHop(IPv4Address address) const
+    {
+        std::map<IPv4Address, MacNodeId>::const_iterator it = forwardingTable_.find(address);
+        if (it == forwardingTable_.end())
+            return 0;
+        return it->second;
+    }
+
+    /**
+     * Returns a counter that is incremented at each change of the
+     * forwarding table: modules caching forwarding decisions compare
+     * it with the value seen when the cache was filled.
+     */
+    unsigned int getForwardingVersion() const
+    {
+        return forwardingVersion_;
+    }
+
     /**
      * Returns the MacNodeId for the given IP address
      *
@@ -264,6 +326,8 @@ class LteBinder : public cSimpleModule
     void setMacNodeId(IPv4Address address, MacNodeId nodeId)
     {
         macNodeIdToIPAddress_[address] = nodeId;
+        forwardingTable_[address] = (nodeId < nextHop_.size()) ? nextHop_[nodeId] : 0;
+        forwardingVersion_++;
     }
     /**
      * Associates the given IP address with the given X2NodeId.
@@ -327,6 +391,13 @@ class LteBinder : public cSimpleModule
     void addUeInfo(UeInfo* info)
     {
         ueList_.push_back(info);
+        ueInfoMap_[info->id] = info;
+    }
+
+    UeInfo* getUeInfo(MacNodeId id)
+    {
+        std::map<MacNodeId, UeInfo*>::iterator it = ueInfoMap_.find(id);
+        return (it != ueInfoMap_.end()) ? it->second : NULL;
     }
 
     std::vector<UeInfo*> * getUeList()
@@ -347,6 +418,8 @@ class LteBinder : public cSimpleModule
      */
     void addD2DCapability(MacNodeId src, MacNodeId dst);
     bool checkD2DCapability(MacNodeId src, MacNodeId dst);
+    // returns the UEs the given UE may communicate with using D2D (NULL if none)
+    const std::set<MacNodeId>* getD2DPeers(MacNodeId src);
     std::map<MacNodeId, std::map<MacNodeId, LteD2DMode> >* getD2DPeeringModeMap();
     void setD2DMode(MacNodeId src, MacNodeId dst, LteD2DMode mode);
     LteD2DMode getD2DMode(MacNodeId src, MacNodeId dst);
@@ -358,6 +431,8 @@ class LteBinder : public cSimpleModule
     void registerMulticastGroup(MacNodeId nodeId, int32 groupId);
     // check if the node is enrolled in the group
     bool isInMulticastGroup(MacNodeId nodeId, int32 groupId);
+    // returns the nodes enrolled in the group (NULL if none)
+    const std::set<MacNodeId>* getMulticastGroupMembers(int32 groupId);
 
     /*
      *  Handover support
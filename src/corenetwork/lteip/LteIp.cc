@@ -122,13 +122,8 @@ void LteIp::endService(cPacket *msg)
             controlInfo->setDstPort(dstPort);
             controlInfo->setSequenceNumber(seqNum_++);
             controlInfo->setHeaderSize(headerSize);
-            MacNodeId destId = getBinder()->getMacNodeId(IPv4Address(controlInfo->getDstAddr()));
-            // master of this ue (myself or a relay)
-            // TODO: KLUDGE:
-            MacNodeId master = getBinder()->getNextHop(destId);
-//            if (master != nodeId_) { // ue is relayed, dest must be the relay
-            destId = master;
-//            } // else ue is directly attached
+            // master of the destination ue (myself or a relay), from the binder forwarding table
+            MacNodeId destId = getBinder()->getNextHop(IPv4Address(controlInfo->getDstAddr()));
             controlInfo->setDestId(destId);
             printControlInfo(controlInfo);
             msg->setControlInfo(controlInfo);
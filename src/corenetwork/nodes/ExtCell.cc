@@ -11,6 +11,18 @@
 
 Define_Module(ExtCell);
 
+/*
+ * SplitMix64 finalizer: maps a counter to a well-mixed 64 bit value.
+ * Used as a counter-based generator for the lazy band status.
+ */
+static uint64_t mix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
 void ExtCell::initialize()
 {
     // get coord
@@ -39,6 +51,9 @@ void ExtCell::initialize()
     }
 
     numBands_ = par("numBands");
+    lazyBandStatus_ = false;
+    statusTti_ = -1;
+    ttiTick_ = NULL;
 
     binder_ = getBinder();
 
@@ -83,11 +98,20 @@ void ExtCell::initialize()
             startingOffset_ = par("startingOffset");
         }
 
-        // TODO: if extCell-interference is disabled, do not send selfMessages
-        /* Start TTI tick */
-        ttiTick_ = new cMessage("ttiTick_");
-        ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
-        scheduleAt(NOW + TTI, ttiTick_);
+        lazyBandStatus_ = par("lazyBandStatus");
+        if (lazyBandStatus_)
+        {
+            // the key is drawn from the module RNG, so that results depend on the seed set only
+            lazySeed_ = ((uint64_t)intuniform(0, 0x7fffffff) << 31) ^ (uint64_t)intuniform(0, 0x7fffffff);
+        }
+        else
+        {
+            // TODO: if extCell-interference is disabled, do not send selfMessages
+            /* Start TTI tick */
+            ttiTick_ = new cMessage("ttiTick_");
+            ttiTick_->setSchedulingPriority(1);        // TTI TICK after other messages
+            scheduleAt(NOW + TTI, ttiTick_);
+        }
     }
 
     // add this cell to the binder
@@ -140,6 +164,47 @@ void ExtCell::updateBandStatus()
     EV << "----- END EXT CELL ALLOCATION UPDATE -----" << endl;
 }
 
+void ExtCell::refreshBandStatus()
+{
+    int64_t tti = NOW.raw() / SimTime(TTI).raw();
+    if (tti == statusTti_)
+        return;
+
+    if (allocationType_ == CONTIGUOUS_ALLOC)
+    {
+        // the contiguous allocation does not change over time: generate it once
+        if (statusTti_ < 0)
+        {
+            statusTti_ = tti;
+            updateBandStatus();
+            prevBandStatus_ = bandStatus_;
+        }
+        return;
+    }
+
+    if (tti == statusTti_ + 1)
+        bandStatus_.swap(prevBandStatus_);
+    else
+        generateBandStatus(prevBandStatus_, tti - 1);
+    generateBandStatus(bandStatus_, tti);
+    statusTti_ = tti;
+}
+
+void ExtCell::generateBandStatus(BandStatus& status, int64_t tti)
+{
+    EV << " ExtCell::generateBandStatus() - generating random allocation for extCell " << id_ << " at TTI " << tti << endl;
+
+    // allocates each band with probability equal to bandUtilization_,
+    // drawing from a generator keyed by (seed, cell, TTI, band)
+    uint64_t key = mix64(mix64(lazySeed_ ^ (uint64_t)id_) ^ (uint64_t)tti);
+    status.resize(numBands_);
+    for (int band = 0; band < numBands_; ++band)
+    {
+        double u = (mix64(key + band) >> 11) * (1.0 / 9007199254740992.0);    // uniform in [0,1)
+        status[band] = (u < bandUtilization_) ? 1 : 0;
+    }
+}
+
 void ExtCell::resetBandStatus()
 {
     prevBandStatus_.clear();
@@ -69,9 +69,24 @@ class ExtCell : public cSimpleModule
     // index of the first allocated RB for CONTIGUOUS_ALLOC allocation type
     int startingOffset_;
 
+    // if true, the band status is generated on demand instead of at each TTI tick
+    bool lazyBandStatus_;
+
+    // TTI the band status refers to (lazy generation only)
+    int64_t statusTti_;
+
+    // key of the counter-based generator (lazy generation only)
+    uint64_t lazySeed_;
+
     // update the band status. Called at each TTI (not used for FULL_ALLOC)
     void updateBandStatus();
 
+    // bring the current and previous band status up to date with the current TTI (lazy generation only)
+    void refreshBandStatus();
+
+    // fill the given status with the RANDOM_ALLOC allocation of the given TTI (lazy generation only)
+    void generateBandStatus(BandStatus& status, int64_t tti);
+
     // move the current status in the prevBandStatus structure and reset the former
     void resetBandStatus();
     /*****************************/
@@ -96,9 +111,19 @@ class ExtCell : public cSimpleModule
 
     void unsetBlock(int band) { bandStatus_.at(band) = 0; }
 
-    int getBandStatus(int band) { return bandStatus_.at(band); }
-
-    int getPrevBandStatus(int band) { return prevBandStatus_.at(band); }
+    int getBandStatus(int band)
+    {
+        if (lazyBandStatus_)
+            refreshBandStatus();
+        return bandStatus_.at(band);
+    }
+
+    int getPrevBandStatus(int band)
+    {
+        if (lazyBandStatus_)
+            refreshBandStatus();
+        return prevBandStatus_.at(band);
+    }
 
     // set the band utilization percentage
     void setBandUtilization(double bandUtilization);
@@ -15,7 +15,7 @@ Define_Module(InternetMux);
 
 InternetMux::InternetMux()
 {
-    // TODO Auto-generated constructor stub
+    forwardingVersion_ = 0;
 }
 
 InternetMux::~InternetMux()
@@ -38,11 +38,9 @@ InternetMux::handleMessage(cMessage *msg)
         // finding next hop for destination node
         FlowControlInfo* controlInfo = check_and_cast<FlowControlInfo*>(msg->getControlInfo());
 
-        MacNodeId dest = getBinder()->getMacNodeId(IPv4Address(controlInfo->getDstAddr()));
+        const ForwardingEntry& entry = getForwardingEntry(controlInfo->getDstAddr());
 
-        MacNodeId nextHop = getBinder()->getNextHop(dest);
-
-        send(msg, routingTable_.at(nextHop)); // send either to nodeB or relay node.
+        send(msg, entry.gate_); // send either to nodeB or relay node.
     }
     else
     {
@@ -51,3 +49,28 @@ InternetMux::handleMessage(cMessage *msg)
     }
     return;
 }
+
+const InternetMux::ForwardingEntry&
+InternetMux::getForwardingEntry(uint32_t destAddr)
+{
+    // entries are dropped as soon as the binder table changes (attach or handover)
+    LteBinder* binder = getBinder();
+    if (binder->getForwardingVersion() != forwardingVersion_)
+    {
+        forwardingTable_.clear();
+        forwardingVersion_ = binder->getForwardingVersion();
+    }
+
+    std::map<uint32_t, ForwardingEntry>::iterator it = forwardingTable_.find(destAddr);
+    if (it != forwardingTable_.end())
+        return it->second;
+
+    ForwardingEntry entry;
+    entry.nextHop_ = binder->getNextHop(IPv4Address(destAddr));
+    std::map<MacNodeId, cGate*>::iterator gt = routingTable_.find(entry.nextHop_);
+    if (gt == routingTable_.end())
+        throw cRuntimeError("InternetMux::getForwardingEntry - no route towards %s (next hop %d)",
+            IPv4Address(destAddr).str().c_str(), entry.nextHop_);
+    entry.gate_ = gt->second;
+    return forwardingTable_[destAddr] = entry;
+}
@@ -20,6 +20,22 @@ class InternetMux : public cSimpleModule
     //* maps destination id to output gate.
     std::map<MacNodeId, cGate*> routingTable_;
 
+    //* forwarding decision for a destination address
+    struct ForwardingEntry
+    {
+        MacNodeId nextHop_;
+        cGate* gate_;
+    };
+
+    //* maps destination address to next hop and output gate, filled lazily from the binder.
+    std::map<uint32_t, ForwardingEntry> forwardingTable_;
+
+    //* binder forwarding version the forwarding table is valid for
+    unsigned int forwardingVersion_;
+
+    //* returns the forwarding entry for the given destination address
+    const ForwardingEntry& getForwardingEntry(uint32_t destAddr);
+
     cGate* muxGate_[2];
 
     virtual void initialize();
@@ -32,6 +48,7 @@ class InternetMux : public cSimpleModule
     void setRoutingEntry(const MacNodeId id, cGate* gate)
     {
         routingTable_[id] = gate;
+        forwardingTable_.clear();
     }
 
     virtual ~InternetMux();
@@ -66,56 +66,122 @@ void LteHarqBufferRx::insertPdu(Codeword cw, LteMacPdu *pdu)
     unsigned char acid = uInfo->getAcid();
     // TODO add codeword to inserPdu
     processes_[acid]->insertPdu(cw, pdu);
+    scheduleEvaluation(acid, cw);
+    // the buffer must be visited by the mac main loop from now on
+    macOwner_->harqRxPending_.insert(nodeId_);
     // debug output
     EV << "H-ARQ RX: new pdu (id " << pdu->getId()
        << " ) inserted into process " << (int) acid << endl;
 }
 
+void LteHarqBufferRx::scheduleEvaluation(unsigned char acid, Codeword cw)
+{
+    RxEvaluation ev;
+    ev.due_ = NOW + HARQ_FB_EVALUATION_INTERVAL;
+    ev.acid_ = acid;
+    ev.cw_ = cw;
+    evaluations_.push_back(ev);
+
+    // a retransmission replaces the corrupted pdu
+    corrupted_.erase(std::make_pair(acid, cw));
+}
+
+void LteHarqBufferRx::trackEvaluatedUnit(unsigned char acid, Codeword cw)
+{
+    RxHarqPduStatus status = processes_[acid]->getUnitStatus(cw);
+    if (status == RXHARQ_PDU_CORRECT)
+        correct_.push_back(std::make_pair(acid, cw));
+    else if (status == RXHARQ_PDU_CORRUPTED)
+        corrupted_.insert(std::make_pair(acid, cw));
+}
+
 void LteHarqBufferRx::sendFeedback()
 {
-    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    std::vector<LteHarqFeedback*> fbList;
+    while (!evaluations_.empty() && evaluations_.front().due_ <= NOW)
     {
-        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        unsigned char i = evaluations_.front().acid_;
+        Codeword cw = evaluations_.front().cw_;
+        evaluations_.pop_front();
+
+        // the unit may have been reset since the pdu was inserted
+        if (!processes_[i]->isEvaluated(cw))
+            continue;
+
+        LteHarqFeedback *hfb = processes_[i]->createFeedback(cw);
+        trackEvaluatedUnit(i, cw);
+
+        // debug output:
+        const char *r = hfb->getResult() ? "ACK" : "NACK";
+        EV << "H-ARQ RX: feedback sent to TX process "
+           << (int) hfb->getAcid() << " Codeword  " << (int) cw
+           << "of node with id "
+           << check_and_cast<UserControlInfo *>(
+            hfb->getControlInfo())->getDestId()
+           << " result: " << r << endl;
+
+        macOwner_->takeObj(hfb);
+        fbList.push_back(hfb);
+    }
+    sendFeedbackList(fbList);
+}
+
+void LteHarqBufferRx::sendFeedbackList(std::vector<LteHarqFeedback*>& fbList)
+{
+    if (fbList.size() > 1 && macOwner_->isHarqFeedbackAggregated())
+    {
+        unsigned int n = fbList.size();
+        LteHarqFeedbackAggregate *aggr = new LteHarqFeedbackAggregate();
+        aggr->setAcidArraySize(n);
+        aggr->setCwArraySize(n);
+        aggr->setResultArraySize(n);
+        aggr->setFbMacPduIdArraySize(n);
+        for (unsigned int i = 0; i < n; i++)
         {
-            if (processes_[i]->isEvaluated(cw))
-            {
-                LteHarqFeedback *hfb = processes_[i]->createFeedback(cw);
-
-                // debug output:
-                const char *r = hfb->getResult() ? "ACK" : "NACK";
-                EV << "H-ARQ RX: feedback sent to TX process "
-                   << (int) hfb->getAcid() << " Codeword  " << (int) cw
-                   << "of node with id "
-                   << check_and_cast<UserControlInfo *>(
-                    hfb->getControlInfo())->getDestId()
-                   << " result: " << r << endl;
-
-                macOwner_->takeObj(hfb);
-                macOwner_->sendLowerPackets(hfb);
-            }
+            aggr->setAcid(i, fbList[i]->getAcid());
+            aggr->setCw(i, fbList[i]->getCw());
+            aggr->setResult(i, fbList[i]->getResult());
+            aggr->setFbMacPduId(i, fbList[i]->getFbMacPduId());
         }
+        aggr->setByteLength(0);
+        // all the feedbacks share source and destination
+        aggr->setControlInfo(fbList[0]->removeControlInfo());
+        for (unsigned int i = 0; i < n; i++)
+            macOwner_->recycleHarqFeedback(fbList[i]);
+
+        EV << "H-ARQ RX: " << n << " feedbacks aggregated in a single packet" << endl;
+
+        macOwner_->takeObj(aggr);
+        macOwner_->sendLowerPackets(aggr);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < fbList.size(); i++)
+            macOwner_->sendLowerPackets(fbList[i]);
     }
+    fbList.clear();
 }
 
 unsigned int LteHarqBufferRx::purgeCorruptedPdus()
 {
     unsigned int purged = 0;
 
-    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    std::set<std::pair<unsigned char, Codeword> >::iterator it;
+    for (it = corrupted_.begin(); it != corrupted_.end(); ++it)
     {
-        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        unsigned char i = it->first;
+        Codeword cw = it->second;
+        if (processes_[i]->getUnitStatus(cw) == RXHARQ_PDU_CORRUPTED)
         {
-            if (processes_[i]->getUnitStatus(cw) == RXHARQ_PDU_CORRUPTED)
-            {
-                EV << "LteHarqBufferRx::purgeCorruptedPdus - purged pdu with acid " << i << endl;
-                // purge PDU
-                processes_[i]->purgeCorruptedPdu(cw);
-                processes_[i]->resetCodeword(cw);
-                //increment purged PDUs counter
-                ++purged;
-            }
+            EV << "LteHarqBufferRx::purgeCorruptedPdus - purged pdu with acid " << (int) i << endl;
+            // purge PDU
+            processes_[i]->purgeCorruptedPdu(cw);
+            processes_[i]->resetCodeword(cw);
+            //increment purged PDUs counter
+            ++purged;
         }
     }
+    corrupted_.clear();
     return purged;
 }
 
@@ -124,69 +190,69 @@ std::list<LteMacPdu *> LteHarqBufferRx::extractCorrectPdus()
     this->sendFeedback();
     std::list<LteMacPdu*> ret;
     unsigned char acid = 0;
-    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    for (unsigned int j = 0; j < correct_.size(); j++)
     {
-        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        unsigned char i = correct_[j].first;
+        Codeword cw = correct_[j].second;
+        if (processes_[i]->isCorrect(cw))
         {
-            if (processes_[i]->isCorrect(cw))
+            LteMacPdu* temp = processes_[i]->extractPdu(cw);
+            unsigned int size = temp->getByteLength();
+            UserControlInfo* info = check_and_cast<UserControlInfo*>(
+                temp->getControlInfo());
+
+            // Calculate delay by subtracting the arrival time
+            // to the MAC packet creation time
+            tSample_->sample_ = (NOW - temp->getCreationTime()).dbl();
+            if (info->getDirection() == DL)
+            {
+                tSample_->id_ = info->getDestId();
+            }
+            else if (info->getDirection() == UL)
+            {
+                tSample_->id_ = info->getSourceId();
+            }
+            else
             {
-                LteMacPdu* temp = processes_[i]->extractPdu(cw);
-                unsigned int size = temp->getByteLength();
-                UserControlInfo* info = check_and_cast<UserControlInfo*>(
-                    temp->getControlInfo());
-
-                // Calculate delay by subtracting the arrival time
-                // to the MAC packet creation time
-                tSample_->sample_ = (NOW - temp->getCreationTime()).dbl();
-                if (info->getDirection() == DL)
-                {
-                    tSample_->id_ = info->getDestId();
-                }
-                else if (info->getDirection() == UL)
-                {
-                    tSample_->id_ = info->getSourceId();
-                }
-                else
-                {
-                    throw cRuntimeError("LteHarqBufferRx::extractCorrectPdus(): unknown direction %d",(int) info->getDirection());
-                }
-
-                // emit delay statistic
-                macOwner_->emit(macDelay_, tSample_);
-
-                // Calculate Throughput by sending the number of bits for this packet
-                tSample_->sample_ = size;
-                tSampleCell_->sample_ = size;
-                if (macOwner_->getNodeType() == UE)
-                {
-                    tSample_->id_ = info->getDestId();
-                    tSampleCell_->id_ = macOwner_->getMacCellId();
-                }
-                else if (macOwner_->getNodeType() == ENODEB)
-                {
-                    tSample_->id_ = info->getSourceId();
-                    tSampleCell_->id_ = info->getDestId();
-                }
-                else
-                {
-                    throw cRuntimeError("LteHarqBufferRx::extractCorrectPdus(): unknown nodeType %d",
-                        (int) macOwner_->getNodeType());
-                }
-
-                // emit throughput statistics
-                nodeB_->emit(macCellThroughput_, tSampleCell_);
-                macOwner_->emit(macThroughput_, tSample_);
-
-                macOwner_->dropObj(temp);
-                ret.push_back(temp);
-                acid = i;
-
-                EV << "LteHarqBufferRx::extractCorrectPdus H-ARQ RX: pdu (id " << ret.back()->getId()
-                   << " ) extracted from process " << (int) acid
-                   << "to be sent upper" << endl;
+                throw cRuntimeError("LteHarqBufferRx::extractCorrectPdus(): unknown direction %d",(int) info->getDirection());
             }
+
+            // emit delay statistic
+            macOwner_->emit(macDelay_, tSample_);
+
+            // Calculate Throughput by sending the number of bits for this packet
+            tSample_->sample_ = size;
+            tSampleCell_->sample_ = size;
+            if (macOwner_->getNodeType() == UE)
+            {
+                tSample_->id_ = info->getDestId();
+                tSampleCell_->id_ = macOwner_->getMacCellId();
+            }
+            else if (macOwner_->getNodeType() == ENODEB)
+            {
+                tSample_->id_ = info->getSourceId();
+                tSampleCell_->id_ = info->getDestId();
+            }
+            else
+            {
+                throw cRuntimeError("LteHarqBufferRx::extractCorrectPdus(): unknown nodeType %d",
+                    (int) macOwner_->getNodeType());
+            }
+
+            // emit throughput statistics
+            nodeB_->emit(macCellThroughput_, tSampleCell_);
+            macOwner_->emit(macThroughput_, tSample_);
+
+            macOwner_->dropObj(temp);
+            ret.push_back(temp);
+            acid = i;
+
+            EV << "LteHarqBufferRx::extractCorrectPdus H-ARQ RX: pdu (id " << ret.back()->getId()
+               << " ) extracted from process " << (int) acid
+               << "to be sent upper" << endl;
         }
     }
+    correct_.clear();
 
     return ret;
 }
@@ -205,6 +271,19 @@ RxBufferStatus LteHarqBufferRx::getBufferStatus()
     return bs;
 }
 
+bool LteHarqBufferRx::isEmpty()
+{
+    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    {
+        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        {
+            if (processes_[i]->getUnitStatus(cw) != RXHARQ_PDU_EMPTY)
+                return false;
+        }
+    }
+    return true;
+}
+
 LteHarqBufferRx::~LteHarqBufferRx()
 {
     std::vector<LteHarqProcessRx *>::iterator it = processes_.begin();
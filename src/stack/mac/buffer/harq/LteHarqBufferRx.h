@@ -10,6 +10,7 @@
 #ifndef _LTE_LTEHARQBUFFERRX_H_
 #define _LTE_LTEHARQBUFFERRX_H_
 
+#include <deque>
 #include "LteMacBase.h"
 #include "LteHarqProcessRx.h"
 
@@ -26,6 +27,8 @@ class LteHarqProcessRx;
  * The operations of checking if a pdu is ready for feedback and if it is in correct state are
  * done in the extractCorrectPdu mehtod which must be called at every tti (it must be part
  * of the mac main loop).
+ * Each inserted pdu is registered in a calendar with the time its evaluation is due, so
+ * that at every tti only the pdus whose evaluation matured are visited.
  */
 class LteHarqBufferRx
 {
@@ -41,6 +44,23 @@ class LteHarqBufferRx
     /// processes vector
     std::vector<LteHarqProcessRx *> processes_;
 
+    /// Calendar entry: unit (acid, cw) whose evaluation is due at time due_
+    struct RxEvaluation
+    {
+        simtime_t due_;
+        unsigned char acid_;
+        Codeword cw_;
+    };
+
+    /// pdus under evaluation, sorted by due time (i.e. by reception time)
+    std::deque<RxEvaluation> evaluations_;
+
+    /// units found correct by the last evaluation, to be extracted
+    std::vector<std::pair<unsigned char, Codeword> > correct_;
+
+    /// units found corrupted, to be purged (or to be retransmitted)
+    std::set<std::pair<unsigned char, Codeword> > corrupted_;
+
     //Statistics
     simsignal_t macDelay_;
     simsignal_t macCellThroughput_;
@@ -96,6 +116,13 @@ class LteHarqBufferRx
     // @return whole buffer status {RXHARQ_PDU_EMPTY, RXHARQ_PDU_EVALUATING, RXHARQ_PDU_CORRECT, RXHARQ_PDU_CORRUPTED }
     RxBufferStatus getBufferStatus();
 
+    /**
+     * Tells whether all the units of all the processes are empty
+     *
+     * @return true if the buffer holds no pdus
+     */
+    bool isEmpty();
+
     /**
      * Returns a pair with h-arq process id and a list of its empty {RXHARQ_PDU_EMPTY} units to be used for reception of new H-arq sub-bursts.
      *
@@ -109,8 +136,34 @@ class LteHarqBufferRx
     /**
      * Checks for all processes if the pdu has been evaluated and sends
      * feedback if affirmative.
+     * Only the units whose evaluation is due are visited
      */
     virtual void sendFeedback();
+
+    /**
+     * Registers a newly inserted pdu in the evaluation calendar
+     *
+     * @param acid process of the pdu
+     * @param cw codeword of the pdu
+     */
+    void scheduleEvaluation(unsigned char acid, Codeword cw);
+
+    /**
+     * Records the outcome of the evaluation of a unit, so that it can be
+     * extracted (if correct) or purged (if corrupted) without scanning the buffer
+     *
+     * @param acid process of the evaluated pdu
+     * @param cw codeword of the evaluated pdu
+     */
+    void trackEvaluatedUnit(unsigned char acid, Codeword cw);
+
+    /**
+     * Sends down the feedbacks created in this TTI. If the mac aggregates
+     * H-ARQ feedbacks, they are carried by a single LteHarqFeedbackAggregate
+     *
+     * @param fbList feedbacks addressed to the peer of this buffer (emptied on return)
+     */
+    void sendFeedbackList(std::vector<LteHarqFeedback*>& fbList);
 };
 
 #endif
@@ -103,6 +103,7 @@ void LteHarqBufferTx::markSelected(UnitList unitIds, unsigned char availableTbs)
     }
 
     selectedAcid_ = acid;
+    macOwner_->harqTxSelected_.insert(nodeId_);
 
     // user tx params could have changed, modify them
     //    UserControlInfo *uInfo = check_and_cast<UserControlInfo *>(basePdu->getControlInfo());
@@ -126,6 +127,7 @@ void LteHarqBufferTx::insertPdu(unsigned char acid, Codeword cw, LteMacPdu *pdu)
         throw cRuntimeError("LteHarqBufferTx::insertPdu(): unit is not empty");
 
     selectedAcid_ = acid;
+    macOwner_->harqTxSelected_.insert(nodeId_);
     numEmptyProc_--;
     (*processes_)[acid]->insertPdu(pdu, cw);
 
@@ -181,11 +183,26 @@ void LteHarqBufferTx::receiveHarqFeedback(LteHarqFeedback *fbpkt)
 {
     EV << "LteHarqBufferTx::receiveHarqFeedback - start" << endl;
 
-    bool result = fbpkt->getResult();
+    // fbMacPduId is the id of the pdu that should receive this fb
+    handleHarqFeedback(fbpkt->getAcid(), fbpkt->getCw(), fbpkt->getResult(), fbpkt->getFbMacPduId());
+
+    ASSERT(fbpkt->getOwner() == this->macOwner_);
+    macOwner_->recycleHarqFeedback(fbpkt);
+}
+
+void LteHarqBufferTx::receiveHarqFeedback(LteHarqFeedbackAggregate *fbpkt)
+{
+    EV << "LteHarqBufferTx::receiveHarqFeedback - aggregated feedback for " << fbpkt->getAcidArraySize() << " units" << endl;
+
+    for (unsigned int i = 0; i < fbpkt->getAcidArraySize(); i++)
+        handleHarqFeedback(fbpkt->getAcid(i), fbpkt->getCw(i), fbpkt->getResult(i), fbpkt->getFbMacPduId(i));
+
+    delete fbpkt;
+}
+
+void LteHarqBufferTx::handleHarqFeedback(unsigned char acid, Codeword cw, bool result, long fbPduId)
+{
     HarqAcknowledgment harqResult = result ? HARQACK : HARQNACK;
-    Codeword cw = fbpkt->getCw();
-    unsigned char acid = fbpkt->getAcid();
-    long fbPduId = fbpkt->getFbMacPduId(); // id of the pdu that should receive this fb
     long unitPduId = (*processes_)[acid]->getPduId(cw);
 
     // After handover or a D2D mode switch, the process nay have been dropped. The received feedback must be ignored.
@@ -193,7 +210,6 @@ void LteHarqBufferTx::receiveHarqFeedback(LteHarqFeedback *fbpkt)
     {
         EV << "H-ARQ TX buffer: received pdu for acid " << (int)acid << ". The corresponding unit has been "
         " reset after handover or a D2D mode switch (the contained pdu was dropped). Ignore feedback." << endl;
-        delete fbpkt;
         return;
     }
 
@@ -215,9 +231,6 @@ void LteHarqBufferTx::receiveHarqFeedback(LteHarqFeedback *fbpkt)
     const char *ack = result ? "ACK" : "NACK";
     EV << "H-ARQ TX: feedback received for process " << (int)acid << " codeword " << (int)cw << ""
     " result is " << ack << endl;
-
-    ASSERT(fbpkt->getOwner() == this->macOwner_);
-    delete fbpkt;
 }
 
 void LteHarqBufferTx::sendSelectedDown()
@@ -130,6 +130,13 @@ class LteHarqBufferTx
      */
     void receiveHarqFeedback(LteHarqFeedback *fbpkt);
 
+    /**
+     * Manages all the H-ARQ feedbacks carried by an aggregated feedback packet
+     *
+     * @param fbpkt received aggregated feedback packet
+     */
+    void receiveHarqFeedback(LteHarqFeedbackAggregate *fbpkt);
+
     /**
      * Sends all pdus contained in units of selected process down
      */
@@ -185,6 +192,16 @@ class LteHarqBufferTx
      * @return true if the id is in the list, false otherwise.
      */
     bool isInUnitList(unsigned char acid, Codeword cw, UnitList unitIds);
+
+    /**
+     * Applies one H-ARQ feedback to the addressed unit
+     *
+     * @param acid addressed process
+     * @param cw addressed codeword
+     * @param result true for ACK, false for NACK
+     * @param fbPduId id of the pdu the feedback refers to
+     */
+    void handleHarqFeedback(unsigned char acid, Codeword cw, bool result, long fbPduId);
 };
 
 #endif
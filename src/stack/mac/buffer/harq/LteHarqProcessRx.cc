@@ -68,17 +68,16 @@ LteHarqFeedback *LteHarqProcessRx::createFeedback(Codeword cw)
         throw cRuntimeError("Cannot send feedback for a pdu not in EVALUATING state");
 
     UserControlInfo *pduInfo = check_and_cast<UserControlInfo *>(pdu_.at(cw)->getControlInfo());
-    LteHarqFeedback *fb = new LteHarqFeedback();
+    LteHarqFeedback *fb = macOwner_->createHarqFeedback();
     fb->setAcid(acid_);
     fb->setCw(cw);
     fb->setResult(result_.at(cw));
     fb->setFbMacPduId(pdu_.at(cw)->getMacPduId());
     fb->setByteLength(0);
-    UserControlInfo *fbInfo = new UserControlInfo();
+    UserControlInfo *fbInfo = check_and_cast<UserControlInfo *>(fb->getControlInfo());
     fbInfo->setSourceId(pduInfo->getDestId());
     fbInfo->setDestId(pduInfo->getSourceId());
     fbInfo->setFrameType(HARQPKT);
-    fb->setControlInfo(fbInfo);
 
     if (!result_.at(cw))
     {
@@ -75,39 +75,47 @@ void LteHarqBufferRxD2D::insertPdu(Codeword cw, LteMacPdu *pdu)
     unsigned char acid = uInfo->getAcid();
     // TODO add codeword to inserPdu
     processes_[acid]->insertPdu(cw, pdu);
+    scheduleEvaluation(acid, cw);
+    // the buffer must be visited by the mac main loop from now on
+    macOwner_->harqRxPending_.insert(nodeId_);
     // debug output
     EV << "H-ARQ RX: new pdu (id " << pdu->getId() << " ) inserted into process " << (int) acid << endl;
 }
 
 void LteHarqBufferRxD2D::sendFeedback()
 {
-    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    std::vector<LteHarqFeedback*> fbList;
+    while (!evaluations_.empty() && evaluations_.front().due_ <= NOW)
     {
-        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        unsigned char i = evaluations_.front().acid_;
+        Codeword cw = evaluations_.front().cw_;
+        evaluations_.pop_front();
+
+        // the unit may have been reset since the pdu was inserted
+        if (!processes_[i]->isEvaluated(cw))
+            continue;
+
+        LteHarqFeedback *hfb = processes_[i]->createFeedback(cw);
+        trackEvaluatedUnit(i, cw);
+        if (hfb == NULL)
         {
-            if (processes_[i]->isEvaluated(cw))
-            {
-                LteHarqFeedback *hfb = processes_[i]->createFeedback(cw);
-                if (hfb == NULL)
-                {
-                    EV<<NOW<<"LteHarqBufferRxD2D::sendFeedback - cw "<< cw << " of process " << i
-                            << " contains a pdu belonging to a multicast/broadcast connection. Don't send feedback." << endl;
-                    continue;
-                }
-
-                // debug output:
-                const char *r = hfb->getResult() ? "ACK" : "NACK";
-                EV << "H-ARQ RX: feedback sent to TX process "
-                   << (int) hfb->getAcid() << " Codeword  " << (int) cw
-                   << "of node with id "
-                   << check_and_cast<UserControlInfo *>(
-                    hfb->getControlInfo())->getDestId()
-                   << " result: " << r << endl;
-
-                macOwner_->sendLowerPackets(hfb);
-            }
+            EV<<NOW<<"LteHarqBufferRxD2D::sendFeedback - cw "<< cw << " of process " << (int)i
+                    << " contains a pdu belonging to a multicast/broadcast connection. Don't send feedback." << endl;
+            continue;
         }
+
+        // debug output:
+        const char *r = hfb->getResult() ? "ACK" : "NACK";
+        EV << "H-ARQ RX: feedback sent to TX process "
+           << (int) hfb->getAcid() << " Codeword  " << (int) cw
+           << "of node with id "
+           << check_and_cast<UserControlInfo *>(
+            hfb->getControlInfo())->getDestId()
+           << " result: " << r << endl;
+
+        fbList.push_back(hfb);
     }
+    sendFeedbackList(fbList);
 }
 
 std::list<LteMacPdu *> LteHarqBufferRxD2D::extractCorrectPdus()
@@ -115,83 +123,83 @@ std::list<LteMacPdu *> LteHarqBufferRxD2D::extractCorrectPdus()
     this->sendFeedback();
     std::list<LteMacPdu*> ret;
     unsigned char acid = 0;
-    for (unsigned int i = 0; i < numHarqProcesses_; i++)
+    for (unsigned int j = 0; j < correct_.size(); j++)
     {
-        for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
+        unsigned char i = correct_[j].first;
+        Codeword cw = correct_[j].second;
+        if (processes_[i]->isCorrect(cw))
         {
-            if (processes_[i]->isCorrect(cw))
+            LteMacPdu* temp = processes_[i]->extractPdu(cw);
+            unsigned int size = temp->getByteLength();
+            UserControlInfo* info = check_and_cast<UserControlInfo*>(
+                temp->getControlInfo());
+
+            // Calculate delay by subtracting the arrival time
+            // to the MAC packet creation time
+            tSample_->sample_ = (NOW - temp->getCreationTime()).dbl();
+            if (info->getDirection() == DL || info->getDirection() == D2D || info->getDirection() == D2D_MULTI)
             {
-                LteMacPdu* temp = processes_[i]->extractPdu(cw);
-                unsigned int size = temp->getByteLength();
-                UserControlInfo* info = check_and_cast<UserControlInfo*>(
-                    temp->getControlInfo());
-
-                // Calculate delay by subtracting the arrival time
-                // to the MAC packet creation time
-                tSample_->sample_ = (NOW - temp->getCreationTime()).dbl();
-                if (info->getDirection() == DL || info->getDirection() == D2D || info->getDirection() == D2D_MULTI)
-                {
-                    tSample_->id_ = info->getDestId();
-                }
-                else if (info->getDirection() == UL)
-                {
-                    tSample_->id_ = info->getSourceId();
-                }
-                else
-                {
-                    throw cRuntimeError("LteHarqBufferRxD2D::extractCorrectPdus(): unknown direction %d",(int) info->getDirection());
-                }
-
-                // emit delay statistic
-                if (info->getDirection() == D2D)
-                {
-                    macOwner_->emit(macDelayD2D_, tSample_);
-                }
-                else
-                {
-                    macOwner_->emit(macDelay_, tSample_);
-                }
-
-                // Calculate Throughput by sending the number of bits for this packet
-                tSample_->sample_ = size;
-                tSampleCell_->sample_ = size;
-                if (macOwner_->getNodeType() == UE)
-                {
-                    tSample_->id_ = info->getDestId();
-                    tSampleCell_->id_ = macOwner_->getMacCellId();
-                }
-                else if (macOwner_->getNodeType() == ENODEB)
-                {
-                    tSample_->id_ = info->getSourceId();
-                    tSampleCell_->id_ = info->getDestId();
-                }
-                else
-                {
-                    throw cRuntimeError("LteHarqBufferRxD2D::extractCorrectPdus(): unknown nodeType %d",
-                        (int) macOwner_->getNodeType());
-                }
-
-                // emit throughput statistics
-                if (info->getDirection() == D2D)
-                {
-                    nodeB_->emit(macCellThroughputD2D_, tSampleCell_);
-                    macOwner_->emit(macThroughputD2D_, tSample_);
-                }
-                else
-                {
-                    nodeB_->emit(macCellThroughput_, tSampleCell_);
-                    macOwner_->emit(macThroughput_, tSample_);
-                }
-
-                ret.push_back(temp);
-                acid = i;
-
-                EV << "LteHarqBufferRxD2D::extractCorrectPdus H-ARQ RX: pdu (id " << ret.back()->getId()
-                   << " ) extracted from process " << (int) acid
-                   << "to be sent upper" << endl;
+                tSample_->id_ = info->getDestId();
             }
+            else if (info->getDirection() == UL)
+            {
+                tSample_->id_ = info->getSourceId();
+            }
+            else
+            {
+                throw cRuntimeError("LteHarqBufferRxD2D::extractCorrectPdus(): unknown direction %d",(int) info->getDirection());
+            }
+
+            // emit delay statistic
+            if (info->getDirection() == D2D)
+            {
+                macOwner_->emit(macDelayD2D_, tSample_);
+            }
+            else
+            {
+                macOwner_->emit(macDelay_, tSample_);
+            }
+
+            // Calculate Throughput by sending the number of bits for this packet
+            tSample_->sample_ = size;
+            tSampleCell_->sample_ = size;
+            if (macOwner_->getNodeType() == UE)
+            {
+                tSample_->id_ = info->getDestId();
+                tSampleCell_->id_ = macOwner_->getMacCellId();
+            }
+            else if (macOwner_->getNodeType() == ENODEB)
+            {
+                tSample_->id_ = info->getSourceId();
+                tSampleCell_->id_ = info->getDestId();
+            }
+            else
+            {
+                throw cRuntimeError("LteHarqBufferRxD2D::extractCorrectPdus(): unknown nodeType %d",
+                    (int) macOwner_->getNodeType());
+            }
+
+            // emit throughput statistics
+            if (info->getDirection() == D2D)
+            {
+                nodeB_->emit(macCellThroughputD2D_, tSampleCell_);
+                macOwner_->emit(macThroughputD2D_, tSample_);
+            }
+            else
+            {
+                nodeB_->emit(macCellThroughput_, tSampleCell_);
+                macOwner_->emit(macThroughput_, tSample_);
+            }
+
+            ret.push_back(temp);
+            acid = i;
+
+            EV << "LteHarqBufferRxD2D::extractCorrectPdus H-ARQ RX: pdu (id " << ret.back()->getId()
+               << " ) extracted from process " << (int) acid
+               << "to be sent upper" << endl;
         }
     }
+    correct_.clear();
 
     return ret;
 }
@@ -39,7 +39,8 @@ void LteHarqBufferTxD2D::receiveHarqFeedback(LteHarqFeedback *fbpkt)
     {
         EV << "H-ARQ TX buffer: received pdu for acid " << (int)acid << ". The corresponding unit has been "
         " reset after handover or a D2D mode switch (the contained pdu was dropped). Ignore feedback." << endl;
-        delete fbpkt;
+        ASSERT(fbpkt->getOwner() == this->macOwner_);
+        macOwner_->recycleHarqFeedback(fbpkt);
         return;
     }
 
@@ -63,7 +64,8 @@ void LteHarqBufferTxD2D::receiveHarqFeedback(LteHarqFeedback *fbpkt)
     const char *ack = result ? "ACK" : "NACK";
     EV << "H-ARQ TX: feedback received for process " << (int)acid << " codeword " << (int)cw << ""
     " result is " << ack << endl;
-    delete fbpkt;
+    ASSERT(fbpkt->getOwner() == this->macOwner_);
+    macOwner_->recycleHarqFeedback(fbpkt);
 }
 
 LteHarqBufferTxD2D::~LteHarqBufferTxD2D()
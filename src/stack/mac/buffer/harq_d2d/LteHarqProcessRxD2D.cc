@@ -37,17 +37,16 @@ LteHarqFeedback *LteHarqProcessRxD2D::createFeedback(Codeword cw)
     }
     else
     {
-        fb = new LteHarqFeedback();
+        fb = macOwner_->createHarqFeedback();
         fb->setAcid(acid_);
         fb->setCw(cw);
         fb->setResult(result_.at(cw));
         fb->setFbMacPduId(pdu_.at(cw)->getId());
         fb->setByteLength(0);
-        UserControlInfo *fbInfo = new UserControlInfo();
+        UserControlInfo *fbInfo = check_and_cast<UserControlInfo *>(fb->getControlInfo());
         fbInfo->setSourceId(pduInfo->getDestId());
         fbInfo->setDestId(pduInfo->getSourceId());
         fbInfo->setFrameType(HARQPKT);
-        fb->setControlInfo(fbInfo);
     }
 
     if (!result_.at(cw))
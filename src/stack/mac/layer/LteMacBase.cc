@@ -25,6 +25,7 @@ LteMacBase::LteMacBase()
 {
     mbuf_.clear();
     macBuffers_.clear();
+    lcgRankCounter_ = 0;
 }
 
 LteMacBase::~LteMacBase()
@@ -102,6 +103,12 @@ void LteMacBase::fromPhy(cPacket *pkt)
 
             throw cRuntimeError("Mac::fromPhy(): Received feedback for an unexisting H-ARQ tx buffer");
         }
+        LteHarqFeedbackAggregate *hfbAggr = dynamic_cast<LteHarqFeedbackAggregate *>(pkt);
+        if (hfbAggr != NULL)
+        {
+            htit->second->receiveHarqFeedback(hfbAggr);
+            return;
+        }
         LteHarqFeedback *hfbpkt = check_and_cast<LteHarqFeedback *>(pkt);
         htit->second->receiveHarqFeedback(hfbpkt);
     }
@@ -184,7 +191,7 @@ bool LteMacBase::bufferizePacket(cPacket* pkt)
         // register connection to lcg map.
         LteTrafficClass tClass = (LteTrafficClass) lteInfo->getTraffic();
 
-        lcgMap_.insert(LcgPair(tClass, CidBufferPair(cid, macBuffers_[cid])));
+        addLcgConnection(tClass, cid, vqueue);
 
         EV << "LteMacBuffers : Using new buffer on node: " <<
         MacCidToNodeId(cid) << " for Lcid: " << MacCidToLcid(cid) << ", Space left in the Queue: " <<
@@ -217,6 +224,7 @@ bool LteMacBase::bufferizePacket(cPacket* pkt)
             return false;
         }
         vqueue->pushBack(vpkt);
+        updateBufferStatus(cid);
 
         EV << "LteMacBuffers : Using old buffer on node: " <<
         MacCidToNodeId(cid) << " for Lcid: " << MacCidToLcid(cid) << ", Space left in the Queue: " <<
@@ -227,6 +235,79 @@ bool LteMacBase::bufferizePacket(cPacket* pkt)
     return true;
 }
 
+void LteMacBase::addLcgConnection(LteTrafficClass tClass, MacCid cid, LteMacBuffer* vqueue)
+{
+    lcgMap_.insert(LcgPair(tClass, CidBufferPair(cid, vqueue)));
+
+    // the ready list is only used by the LCG schedulers of the UEs
+    if (nodeType_ == ENODEB)
+        return;
+
+    lcgRank_[cid] = LcgRank(tClass, lcgRankCounter_++);
+    updateBufferStatus(cid);
+}
+
+void LteMacBase::removeLcgConnection(MacCid cid)
+{
+    LcgMap::iterator lt = lcgMap_.begin();
+    for (; lt != lcgMap_.end(); )
+    {
+        if (lt->second.first == cid)
+        {
+            lcgMap_.erase(lt++);
+        }
+        else
+        {
+            ++lt;
+        }
+    }
+
+    std::map<MacCid, LcgRank>::iterator rit = lcgRank_.find(cid);
+    if (rit != lcgRank_.end())
+    {
+        lcgReadyList_.erase(rit->second);
+        lcgRank_.erase(rit);
+    }
+}
+
+void LteMacBase::updateBufferStatus(MacCid cid)
+{
+    std::map<MacCid, LcgRank>::const_iterator rit = lcgRank_.find(cid);
+    if (rit == lcgRank_.end())
+        return;    // connection not registered in the LCG map
+
+    LteMacBufferMap::const_iterator bit = macBuffers_.find(cid);
+    if (bit == macBuffers_.end() || bit->second->isEmpty())
+        lcgReadyList_.erase(rit->second);
+    else
+        lcgReadyList_.insert(LcgReadyList::value_type(rit->second, CidBufferPair(cid, bit->second)));
+}
+
+LteHarqFeedback* LteMacBase::createHarqFeedback()
+{
+    LteHarqFeedback* fb = harqFbPool_.get();
+    if (fb == NULL)
+    {
+        fb = new LteHarqFeedback();
+        fb->setControlInfo(new UserControlInfo());
+        return fb;
+    }
+
+    // feedbacks are pooled along with their control info, unless
+    // it has been moved to an aggregated feedback
+    UserControlInfo* fbInfo = dynamic_cast<UserControlInfo*>(fb->getControlInfo());
+    if (fbInfo == NULL)
+        fb->setControlInfo(new UserControlInfo());
+    else
+        fbInfo->reset();
+    return fb;
+}
+
+void LteMacBase::recycleHarqFeedback(LteHarqFeedback* fb)
+{
+    harqFbPool_.put(fb);
+}
+
 void LteMacBase::deleteQueues(MacNodeId nodeId)
 {
     LteMacBuffers::iterator mit;
@@ -254,6 +335,7 @@ void LteMacBase::deleteQueues(MacNodeId nodeId)
         {
             while (!vit->second->isEmpty())
                 vit->second->popFront();
+            removeLcgConnection(vit->first);
             delete vit->second;        // Delete Queue
             macBuffers_.erase(vit++);        // Delete Elem
         }
@@ -277,6 +359,9 @@ void LteMacBase::deleteQueues(MacNodeId nodeId)
             ++hit;
         }
     }
+    harqTxSelected_.erase(nodeId);
+    harqRxPending_.erase(nodeId);
+
     HarqRxBuffers::iterator hit2;
     for (hit2 = harqRxBuffers_.begin(); hit2 != harqRxBuffers_.end();)
     {
@@ -317,12 +402,14 @@ void LteMacBase::initialize(int stage)
 
         /* Get reference to binder */
         binder_ = getBinder();
+        profiler_ = binder_->getProfiler();
 
         /* Set The MAC MIB */
 
         muMimo_ = par("muMimo");
 
         harqProcesses_ = par("harqProcesses");
+        aggregateHarqFeedback_ = par("aggregateHarqFeedback");
 
         /* Start TTI tick */
         ttiTick_ = new cMessage("ttiTick_");
@@ -11,12 +11,15 @@
 #define _LTE_LTEMACBASE_H_
 
 #include "LteCommon.h"
+#include "LteMessagePool.h"
 
 class LteHarqBufferTx;
 class LteHarqBufferRx;
 class LteBinder;
+class LteProfiler;
 class FlowControlInfo;
 class LteMacBuffer;
+class LteHarqFeedback;
 
 /**
  * Map associating a nodeId with the corresponding TX H-ARQ buffer.
@@ -38,6 +41,14 @@ typedef std::pair<MacCid, LteMacBuffer*> CidBufferPair;
 typedef std::pair<LteTrafficClass, CidBufferPair> LcgPair;
 typedef std::multimap<LteTrafficClass, CidBufferPair> LcgMap;
 
+/*
+ * Ready list of the backlogged connections of the LcgMap, in LCG priority order:
+ * connections are sorted by traffic class and, within the same class, by
+ * registration order (the same order of the LcgMap)
+ */
+typedef std::pair<LteTrafficClass, unsigned int> LcgRank;
+typedef std::map<LcgRank, CidBufferPair> LcgReadyList;
+
 /**
  * @class LteMacBase
  * @brief MAC Layer
@@ -73,6 +84,9 @@ class LteMacBase : public cSimpleModule
      */
     LteBinder *binder_;
 
+    // per-TTI stages profiler (NULL if profiling is disabled)
+    LteProfiler* profiler_;
+
     /*
      * Gates
      */
@@ -86,6 +100,9 @@ class LteMacBase : public cSimpleModule
 
     int harqProcesses_;
 
+    /// Send the H-ARQ feedbacks to the same peer within a TTI in a single frame
+    bool aggregateHarqFeedback_;
+
     /// TTI self message
     cMessage* ttiTick_;
 
@@ -116,6 +133,16 @@ class LteMacBase : public cSimpleModule
     /// Harq Rx Buffers
     HarqRxBuffers harqRxBuffers_;
 
+    /*
+     * Peers whose H-ARQ buffers need per-TTI processing. They are kept
+     * up to date by the H-ARQ buffers themselves, so that the eNB main loop
+     * and the UL retransmission scheduler visit only these peers:
+     * - harqRxPending_ : RX buffers holding at least one pdu
+     * - harqTxSelected_ : TX buffers with a process selected for transmission
+     */
+    std::set<MacNodeId> harqRxPending_;
+    std::set<MacNodeId> harqTxSelected_;
+
     /* Connection Descriptors
      * Holds flow related infos
      */
@@ -130,12 +157,24 @@ class LteMacBase : public cSimpleModule
      * TODO : delete/update entries on hand-over
      */
     LcgMap lcgMap_;
+
+    /* Connections of the LCG map whose virtual buffer is not empty, and rank
+     * of all the registered connections. Kept up to date by updateBufferStatus(),
+     * called by the UE LCG schedulers. Not maintained at the eNB
+     */
+    LcgReadyList lcgReadyList_;
+    std::map<MacCid, LcgRank> lcgRank_;
+    unsigned int lcgRankCounter_;
+
     // Node Type;
     LteNodeType nodeType_;
 
     // record the last TTI that HARQ processes for a given UE have been aborted (useful for D2D switching)
     std::map<MacNodeId, simtime_t> resetHarq_;
 
+    // H-ARQ feedbacks received by this MAC, reused for the feedbacks it sends
+    LteMessagePool<LteHarqFeedback> harqFbPool_;
+
   public:
 
     /**
@@ -168,6 +207,18 @@ class LteMacBase : public cSimpleModule
         take(obj);
     }
 
+    /**
+     * Returns an H-ARQ feedback with an empty control info, reusing
+     * one of the feedbacks handled by this MAC if available
+     */
+    LteHarqFeedback* createHarqFeedback();
+
+    /**
+     * Gives back a handled H-ARQ feedback, owned by this MAC,
+     * to be reused by createHarqFeedback()
+     */
+    void recycleHarqFeedback(LteHarqFeedback* fb);
+
     /*
      * Getters
      */
@@ -193,6 +244,20 @@ class LteMacBase : public cSimpleModule
         return lcgMap_;
     }
 
+    // Returns the backlogged connections of the LCG map, in priority order
+    const LcgReadyList& getLcgReadyList()
+    {
+        return lcgReadyList_;
+    }
+
+    /**
+     * Updates the ready list after SDUs have been added to or removed
+     * from the virtual buffer of a connection of the LCG map
+     *
+     * @param cid connection whose virtual buffer has changed
+     */
+    void updateBufferStatus(MacCid cid);
+
     // Returns connection descriptors
     std::map<MacCid, FlowControlInfo>& getConnDesc()
     {
@@ -211,12 +276,24 @@ class LteMacBase : public cSimpleModule
         return &harqRxBuffers_;
     }
 
+    // Returns the peers whose harq rx buffers hold pdus
+    const std::set<MacNodeId>& getHarqRxPending() const
+    {
+        return harqRxPending_;
+    }
+
     // Returns number of Harq Processes
     unsigned int harqProcesses() const
     {
         return harqProcesses_;
     }
 
+    // Returns true if H-ARQ feedbacks must be aggregated
+    bool isHarqFeedbackAggregated() const
+    {
+        return aggregateHarqFeedback_;
+    }
+
     // Returns the MU-MIMO enabled flag
     bool muMimo() const
     {
@@ -315,6 +392,17 @@ class LteMacBase : public cSimpleModule
      */
     virtual bool bufferizePacket(cPacket* pkt);
 
+    /**
+     * Registers a connection and its virtual buffer in the LCG map
+     * and, on UEs, in the ready list if the buffer is not empty
+     */
+    void addLcgConnection(LteTrafficClass tClass, MacCid cid, LteMacBuffer* vqueue);
+
+    /**
+     * Removes a connection from the LCG map and from the ready list
+     */
+    void removeLcgConnection(MacCid cid);
+
     /**
      * handleUpperMessage() is called every time a packet is
      * received from the upper layer
@@ -12,6 +12,7 @@
 #include "LteMacBuffer.h"
 #include "LteMacQueue.h"
 #include "LteFeedbackPkt.h"
+#include "LtePhyUe.h"
 #include "LteSchedulerEnbDl.h"
 #include "LteSchedulerEnbUl.h"
 #include "LteSchedulingGrant.h"
@@ -20,6 +21,7 @@
 #include "UserTxParams.h"
 #include "LteRac_m.h"
 #include "LteCommon.h"
+#include "LteProfiler.h"
 
 Define_Module( LteMacEnb);
 
@@ -390,7 +392,7 @@ void LteMacEnb::sendGrants(LteMacScheduleList* scheduleList)
            << codewords << " codewords. CW[" << cw << "\\" << otherCw << "]" << endl;
 
         // TODO Grant is set aperiodic as default
-        LteSchedulingGrant* grant = new LteSchedulingGrant("LteGrant");
+        LteSchedulingGrant* grant = createGrant(nodeId);
 
         grant->setDirection(UL);
 
@@ -399,17 +401,9 @@ void LteMacEnb::sendGrants(LteMacScheduleList* scheduleList)
         // set total granted blocks
         grant->setTotalGrantedBlocks(granted);
 
-        UserControlInfo* uinfo = new UserControlInfo();
-        uinfo->setSourceId(getMacNodeId());
-        uinfo->setDestId(nodeId);
-        uinfo->setFrameType(GRANTPKT);
-
-        grant->setControlInfo(uinfo);
-
         // get and set the user's UserTxParams
         const UserTxParams& ui = getAmc()->computeTxParams(nodeId, UL);
-        UserTxParams* txPara = new UserTxParams(ui);
-        grant->setUserTxParams(txPara);
+        grant->copyUserTxParams(ui);
 
         // acquiring remote antennas set from user info
         const std::set<Remote>& antennas = ui.readAntennaSet();
@@ -450,6 +444,39 @@ void LteMacEnb::sendGrants(LteMacScheduleList* scheduleList)
     }
 }
 
+LteSchedulingGrant* LteMacEnb::createGrant(MacNodeId nodeId)
+{
+    LteSchedulingGrant* grant = grantPool_.get();
+    UserControlInfo* uinfo;
+    if (grant == NULL)
+    {
+        grant = new LteSchedulingGrant("LteGrant");
+        uinfo = new UserControlInfo();
+        grant->setControlInfo(uinfo);
+    }
+    else
+    {
+        // grants are pooled along with their control info
+        grant->reset();
+        uinfo = check_and_cast<UserControlInfo*>(grant->getControlInfo());
+        uinfo->reset();
+    }
+    uinfo->setSourceId(getMacNodeId());
+    uinfo->setDestId(nodeId);
+    uinfo->setFrameType(GRANTPKT);
+    return grant;
+}
+
+void LteMacEnb::recycleGrant(LteSchedulingGrant* grant)
+{
+    Enter_Method_Silent("recycleGrant");
+    take(grant);
+    if (dynamic_cast<UserControlInfo*>(grant->getControlInfo()) != NULL)
+        grantPool_.put(grant);
+    else
+        delete grant;
+}
+
 void LteMacEnb::macHandleRac(cPacket* pkt)
 {
     EV << NOW << " LteMacEnb::macHandleRac" << endl;
@@ -680,20 +707,31 @@ void LteMacEnb::handleSelfMessage()
 
     /* Reception */
 
-    // extract pdus from all harqrxbuffers and pass them to unmaker
-    HarqRxBuffers::iterator hit = harqRxBuffers_.begin();
-    HarqRxBuffers::iterator het = harqRxBuffers_.end();
+    // extract pdus from the harqrxbuffers holding pdus and pass them to unmaker
+    HarqRxBuffers::iterator hit;
+    std::set<MacNodeId>::iterator pit;
     LteMacPdu *pdu = NULL;
     std::list<LteMacPdu*> pduList;
 
-    for (; hit != het; hit++)
     {
-        pduList = hit->second->extractCorrectPdus();
-        while (!pduList.empty())
+        LteProfilerScope prof(profiler_, nodeId_, PROF_HARQ_RX);
+        for (pit = harqRxPending_.begin(); pit != harqRxPending_.end();)
         {
-            pdu = pduList.front();
-            pduList.pop_front();
-            macPduUnmake(pdu);
+            hit = harqRxBuffers_.find(*pit);
+            if (hit == harqRxBuffers_.end())
+            {
+                // the buffer has been deleted meanwhile
+                harqRxPending_.erase(pit++);
+                continue;
+            }
+            pduList = hit->second->extractCorrectPdus();
+            while (!pduList.empty())
+            {
+                pdu = pduList.front();
+                pduList.pop_front();
+                macPduUnmake(pdu);
+            }
+            ++pit;
         }
     }
 
@@ -702,9 +740,13 @@ void LteMacEnb::handleSelfMessage()
     //TODO enable sleep mode also for UPLINK???
     (enbSchedulerUl_->resourceBlocks()) = getNumRbUl();
 
-    enbSchedulerUl_->updateHarqDescs();
+    LteMacScheduleList* scheduleListUl;
+    {
+        LteProfilerScope prof(profiler_, nodeId_, PROF_SCHEDULE_UL);
+        enbSchedulerUl_->updateHarqDescs();
 
-    LteMacScheduleList* scheduleListUl = enbSchedulerUl_->schedule();
+        scheduleListUl = enbSchedulerUl_->schedule();
+    }
     // send uplink grants to PHY layer
     sendGrants(scheduleListUl);
     EV << "============================================ END UPLINK ============================================" << endl;
@@ -720,22 +762,45 @@ void LteMacEnb::handleSelfMessage()
     if (activation)
     {
         // perform Downlink scheduling
-        LteMacScheduleList* scheduleListDl = enbSchedulerDl_->schedule();
+        LteMacScheduleList* scheduleListDl;
+        {
+            LteProfilerScope prof(profiler_, nodeId_, PROF_SCHEDULE_DL);
+            scheduleListDl = enbSchedulerDl_->schedule();
+        }
         // creates pdus from schedule list and puts them in harq buffers
+        LteProfilerScope prof(profiler_, nodeId_, PROF_PDU_MAKE);
         macPduMake(scheduleListDl);
     }
     EV << "========================================== END DOWNLINK ============================================" << endl;
 
-    // purge from corrupted PDUs all Rx H-HARQ buffers for all users
-    for (hit = harqRxBuffers_.begin(); hit != het; hit++)
+    // purge from corrupted PDUs the Rx H-HARQ buffers holding pdus,
+    // and stop visiting those that have been left empty
+    for (pit = harqRxPending_.begin(); pit != harqRxPending_.end();)
     {
-        hit->second->purgeCorruptedPdus();
+        hit = harqRxBuffers_.find(*pit);
+        if (hit != harqRxBuffers_.end())
+        {
+            hit->second->purgeCorruptedPdus();
+            if (!hit->second->isEmpty())
+            {
+                ++pit;
+                continue;
+            }
+        }
+        harqRxPending_.erase(pit++);
     }
 
-    // flush Tx H-ARQ buffers for all users
+    // flush Tx H-ARQ buffers for the users having a selected process
+    LteProfilerScope prof(profiler_, nodeId_, PROF_HARQ_TX);
+    std::set<MacNodeId> selected;
+    selected.swap(harqTxSelected_);
     HarqTxBuffers::iterator it;
-    for (it = harqTxBuffers_.begin(); it != harqTxBuffers_.end(); it++)
-        it->second->sendSelectedDown();
+    for (pit = selected.begin(); pit != selected.end(); ++pit)
+    {
+        it = harqTxBuffers_.find(*pit);
+        if (it != harqTxBuffers_.end())
+            it->second->sendSelectedDown();
+    }
 
     EV << "--- END " << ((nodeType==MACRO_ENB)?"MACRO":"MICRO") << " ENB MAIN LOOP ---" << endl;
 }
@@ -772,7 +837,29 @@ void LteMacEnb::macHandleFeedbackPkt(cPacket *pkt)
                 amc_->pushFeedback(id, UL, (*jt));
         }
     }
-    delete fb;
+
+    // give the packet back to the PHY of the UE that sent it, to be reused for its
+    // next report. Feedback computed by the cell-wide pass has no control info
+    LtePhyUe* uePhy = NULL;
+    if (fb->getControlInfo() != NULL)
+    {
+        cModule* ueMac = getMacByMacNodeId(id);
+        if (ueMac != NULL)
+            uePhy = dynamic_cast<LtePhyUe*>(ueMac->getParentModule()->getSubmodule("phy"));
+    }
+    if (uePhy != NULL)
+        uePhy->recycleFeedback(fb);
+    else
+        delete fb;
+}
+
+void LteMacEnb::deliverFeedback(cPacket* pkt)
+{
+    Enter_Method_Silent("deliverFeedback");
+    take(pkt);
+
+    EV << NOW << " LteMacEnb::deliverFeedback - node " << nodeId_ << " received batched feedback" << endl;
+    macHandleFeedbackPkt(pkt);
 }
 
 void LteMacEnb::updateUserTxParam(cPacket* pkt)
@@ -14,8 +14,10 @@
 #include "LteDeployer.h"
 #include "LteAmc.h"
 #include "LteCommon.h"
+#include "LteMessagePool.h"
 
 class MacBsr;
+class LteSchedulingGrant;
 class LteSchedulerEnbDl;
 class LteSchedulerEnbUl;
 
@@ -79,6 +81,15 @@ class LteMacEnb : public LteMacBase
     // Resource Elements per Rb - MBSFN frames
     std::vector<double> rePerRbMbsfn_;
 
+    /// Grants given back by the UEs, reused by sendGrants()
+    LteMessagePool<LteSchedulingGrant> grantPool_;
+
+    /**
+     * Returns a grant for the given UE, with its control info set,
+     * reusing one of the grants given back by the UEs if available
+     */
+    LteSchedulingGrant* createGrant(MacNodeId nodeId);
+
     /// Buffer for the BSRs
     LteMacBufferMap bsrbuf_;
 
@@ -178,6 +189,18 @@ class LteMacEnb : public LteMacBase
     LteMacEnb();
     virtual ~LteMacEnb();
 
+    /**
+     * Handles a feedback packet computed by the PHY in its cell-wide
+     * feedback pass (see LtePhyEnb), without going through the gates
+     */
+    void deliverFeedback(cPacket* pkt);
+
+    /**
+     * Gives back a grant sent by this eNB, once the UE does not use it
+     * anymore, so that it can be reused for the following grants
+     */
+    void recycleGrant(LteSchedulingGrant* grant);
+
     /// Returns the BSR virtual buffers
     LteMacBufferMap* getBsrVirtualBuffers()
     {
@@ -200,25 +200,16 @@ void LteMacEnbD2D::sendGrants(LteMacScheduleList* scheduleList)
            << codewords << " codewords. CW[" << cw << "\\" << otherCw << "] dir[" << dirToA(dir) << "]" << endl;
 
         // TODO Grant is set aperiodic as default
-        LteSchedulingGrant* grant = new LteSchedulingGrant("LteGrant");
+        LteSchedulingGrant* grant = createGrant(nodeId);
         grant->setDirection(dir);
         grant->setCodewords(codewords);
 
         // set total granted blocks
         grant->setTotalGrantedBlocks(granted);
 
-        UserControlInfo* uinfo = new UserControlInfo();
-        uinfo->setSourceId(getMacNodeId());
-        uinfo->setDestId(nodeId);
-        uinfo->setFrameType(GRANTPKT);
-
-        grant->setControlInfo(uinfo);
-
         // get and set the user's UserTxParams
         const UserTxParams& ui = getAmc()->computeTxParams(nodeId, dir);
-        UserTxParams* txPara = new UserTxParams(ui);
-        // FIXME: possible memory leak
-        grant->setUserTxParams(txPara);
+        grant->copyUserTxParams(ui);
 
         // acquiring remote antennas set from user info
         const std::set<Remote>& antennas = ui.readAntennaSet();
@@ -22,6 +22,7 @@
 #include "LteRac_m.h"
 #include "LteCommon.h"
 #include "LteMacSduRequest.h"
+#include "LteProfiler.h"
 
 Define_Module( LteMacEnbRealistic);
 
@@ -33,6 +34,8 @@ LteMacEnbRealistic::LteMacEnbRealistic() :
     LteMacEnb()
 {
     scheduleListDl_ = NULL;
+    fullBufferDl_ = false;
+    fullBufferVersion_ = 0;
 }
 
 LteMacEnbRealistic::~LteMacEnbRealistic()
@@ -61,6 +64,8 @@ void LteMacEnbRealistic::initialize(int stage)
         /* Create and initialize MAC Uplink scheduler */
         enbSchedulerUl_ = new LteSchedulerEnbUl();
         enbSchedulerUl_->initialize(UL, this);
+
+        fullBufferDl_ = par("fullBufferDl");
     }
     LteMacEnb::initialize(stage);
 }
@@ -84,6 +89,9 @@ void LteMacEnbRealistic::macSduRequest()
 {
     EV << "----- START LteMacEnbRealistic::macSduRequest -----\n";
 
+    // full-buffer connections, whose SDUs are made here instead of being requested
+    std::set<MacCid> fullBufferCids;
+
     // Ask for a MAC sdu for each scheduled user on each codeword
     LteMacScheduleList::const_iterator it;
     for (it = scheduleListDl_->begin(); it != scheduleListDl_->end(); it++)
@@ -102,6 +110,16 @@ void LteMacEnbRealistic::macSduRequest()
             allocatedBytes += enbSchedulerDl_->allocator_->getBytes(MACRO,b,destId);
         }
 
+        if (MacCidToLcid(destCid) == FULL_BUFFER_LCID)
+        {
+            if (allocatedBytes > MAC_HEADER)
+            {
+                makeFullBufferSdus(destCid, it->second, allocatedBytes - MAC_HEADER);
+                fullBufferCids.insert(destCid);
+            }
+            continue;
+        }
+
         // send the request message to the upper layer
         LteMacSduRequest* macSduRequest = new LteMacSduRequest("LteMacSduRequest");
         macSduRequest->setUeId(destId);
@@ -111,11 +129,91 @@ void LteMacEnbRealistic::macSduRequest()
         sendUpperPackets(macSduRequest);
     }
 
+    // full-buffer SDUs are available right away: build their PDUs
+    std::set<MacCid>::iterator fit;
+    for (fit = fullBufferCids.begin(); fit != fullBufferCids.end(); ++fit)
+        macPduMake(*fit);
+
     EV << "------ END LteMacEnbRealistic::macSduRequest ------\n";
 }
 
+void LteMacEnbRealistic::updateFullBufferConnections()
+{
+    // the set of served UEs changes only on attach and handover
+    if (fullBufferUes_.empty() || fullBufferVersion_ != binder_->getForwardingVersion())
+    {
+        fullBufferVersion_ = binder_->getForwardingVersion();
+        fullBufferUes_.clear();
+        ConnectedUesMap ues = binder_->getDeployedUes(nodeId_, DL);
+        ConnectedUesMap::iterator uit;
+        for (uit = ues.begin(); uit != ues.end(); ++uit)
+        {
+            if (uit->second)
+                fullBufferUes_.insert(uit->first);
+        }
+    }
+
+    std::set<MacNodeId>::iterator it;
+    for (it = fullBufferUes_.begin(); it != fullBufferUes_.end(); ++it)
+    {
+        MacCid cid = idToMacCid(*it, FULL_BUFFER_LCID);
+        LteMacBuffer* vqueue;
+        LteMacBufferMap::iterator bit = macBuffers_.find(cid);
+        if (bit == macBuffers_.end())
+        {
+            // the connection has no counterpart in the upper layers
+            FlowControlInfo desc;
+            desc.setSourceId(nodeId_);
+            desc.setDestId(*it);
+            desc.setLcid(FULL_BUFFER_LCID);
+            desc.setDirection(DL);
+            desc.setRlcType(UM);
+            desc.setTraffic(BACKGROUND);
+            connDesc_[cid] = desc;
+
+            vqueue = new LteMacBuffer();
+            macBuffers_[cid] = vqueue;
+            addLcgConnection(BACKGROUND, cid, vqueue);
+
+            EV << "LteMacEnbRealistic::updateFullBufferConnections - new full-buffer connection for UE " << *it << endl;
+        }
+        else
+        {
+            vqueue = bit->second;
+        }
+
+        // restore the backlog consumed by the last grant
+        if (vqueue->getQueueOccupancy() < FULL_BUFFER_BACKLOG)
+        {
+            while (!vqueue->isEmpty())
+                vqueue->popFront();
+            vqueue->pushBack(PacketInfo(FULL_BUFFER_BACKLOG, NOW));
+        }
+        enbSchedulerDl_->backlog(cid);
+    }
+}
+
+void LteMacEnbRealistic::makeFullBufferSdus(MacCid cid, unsigned int numSdus, unsigned int sduSize)
+{
+    LteMacBuffers::iterator qit = mbuf_.find(cid);
+    if (qit == mbuf_.end())
+        qit = mbuf_.insert(std::pair<MacCid, LteMacQueue*>(cid, new LteMacQueue(queueSize_))).first;
+
+    // the first SDU also takes the remainder of the split
+    for (unsigned int i = 0; i < numSdus; ++i)
+    {
+        cPacket* sdu = new cPacket("fullBufferSdu");
+        sdu->setByteLength(sduSize / numSdus + ((i == 0) ? sduSize % numSdus : 0));
+        sdu->setControlInfo(connDesc_[cid].dup());
+        sdu->setTimestamp();
+        qit->second->pushBack(sdu);
+    }
+}
+
 void LteMacEnbRealistic::macPduMake(MacCid cid)
 {
+    LteProfilerScope prof(profiler_, nodeId_, PROF_PDU_MAKE);
+
     EV << "----- START LteMacEnbRealistic::macPduMake -----\n";
     // Finalizes the scheduling decisions according to the schedule list,
     // detaching sdus from real buffers.
@@ -280,7 +378,7 @@ bool LteMacEnbRealistic::bufferizePacket(cPacket* pkt)
             // register connection to lcg map.
             LteTrafficClass tClass = (LteTrafficClass) lteInfo->getTraffic();
 
-            lcgMap_.insert(LcgPair(tClass, CidBufferPair(cid, macBuffers_[cid])));
+            addLcgConnection(tClass, cid, vqueue);
 
             EV << "LteMacBuffers : Using new buffer on node: " <<
             MacCidToNodeId(cid) << " for Lcid: " << MacCidToLcid(cid) << ", Bytes in the Queue: " <<
@@ -384,20 +482,31 @@ void LteMacEnbRealistic::handleSelfMessage()
 
     /* Reception */
 
-    // extract pdus from all harqrxbuffers and pass them to unmaker
-    HarqRxBuffers::iterator hit = harqRxBuffers_.begin();
-    HarqRxBuffers::iterator het = harqRxBuffers_.end();
+    // extract pdus from the harqrxbuffers holding pdus and pass them to unmaker
+    HarqRxBuffers::iterator hit;
+    std::set<MacNodeId>::iterator pit;
     LteMacPdu *pdu = NULL;
     std::list<LteMacPdu*> pduList;
 
-    for (; hit != het; hit++)
     {
-        pduList = hit->second->extractCorrectPdus();
-        while (!pduList.empty())
+        LteProfilerScope prof(profiler_, nodeId_, PROF_HARQ_RX);
+        for (pit = harqRxPending_.begin(); pit != harqRxPending_.end();)
         {
-            pdu = pduList.front();
-            pduList.pop_front();
-            macPduUnmake(pdu);
+            hit = harqRxBuffers_.find(*pit);
+            if (hit == harqRxBuffers_.end())
+            {
+                // the buffer has been deleted meanwhile
+                harqRxPending_.erase(pit++);
+                continue;
+            }
+            pduList = hit->second->extractCorrectPdus();
+            while (!pduList.empty())
+            {
+                pdu = pduList.front();
+                pduList.pop_front();
+                macPduUnmake(pdu);
+            }
+            ++pit;
         }
     }
 
@@ -406,9 +515,13 @@ void LteMacEnbRealistic::handleSelfMessage()
     //TODO enable sleep mode also for UPLINK???
     (enbSchedulerUl_->resourceBlocks()) = getNumRbUl();
 
-    enbSchedulerUl_->updateHarqDescs();
+    LteMacScheduleList* scheduleListUl;
+    {
+        LteProfilerScope prof(profiler_, nodeId_, PROF_SCHEDULE_UL);
+        enbSchedulerUl_->updateHarqDescs();
 
-    LteMacScheduleList* scheduleListUl = enbSchedulerUl_->schedule();
+        scheduleListUl = enbSchedulerUl_->schedule();
+    }
     // send uplink grants to PHY layer
     sendGrants(scheduleListUl);
     EV << "============================================ END UPLINK ============================================" << endl;
@@ -427,18 +540,30 @@ void LteMacEnbRealistic::handleSelfMessage()
         if (scheduleListDl_ != NULL)
             scheduleListDl_->clear();
 
+        if (fullBufferDl_)
+            updateFullBufferConnections();
+
         // perform Downlink scheduling
-        scheduleListDl_ = enbSchedulerDl_->schedule();
+        {
+            LteProfilerScope prof(profiler_, nodeId_, PROF_SCHEDULE_DL);
+            scheduleListDl_ = enbSchedulerDl_->schedule();
+        }
 
         // requests SDUs to the RLC layer
         macSduRequest();
     }
     EV << "========================================== END DOWNLINK ============================================" << endl;
 
-    // purge from corrupted PDUs all Rx H-HARQ buffers for all users
-    for (; hit != het; hit++)
+    // corrupted PDUs are not purged here: they are kept in the Rx H-ARQ buffers
+    // until the corresponding retransmission is received. Only the buffers that
+    // have been left empty are no longer visited
+    for (pit = harqRxPending_.begin(); pit != harqRxPending_.end();)
     {
-        hit->second->purgeCorruptedPdus();
+        hit = harqRxBuffers_.find(*pit);
+        if (hit != harqRxBuffers_.end() && !hit->second->isEmpty())
+            ++pit;
+        else
+            harqRxPending_.erase(pit++);
     }
 
     // Message that triggers flushing of Tx H-ARQ buffers for all users
@@ -452,9 +577,19 @@ void LteMacEnbRealistic::handleSelfMessage()
 
 void LteMacEnbRealistic::flushHarqBuffers()
 {
+    LteProfilerScope prof(profiler_, nodeId_, PROF_HARQ_TX);
+
+    // only the users having a selected process have something to send
+    std::set<MacNodeId> selected;
+    selected.swap(harqTxSelected_);
+    std::set<MacNodeId>::iterator pit;
     HarqTxBuffers::iterator it;
-    for (it = harqTxBuffers_.begin(); it != harqTxBuffers_.end(); it++)
-        it->second->sendSelectedDown();
+    for (pit = selected.begin(); pit != selected.end(); ++pit)
+    {
+        it = harqTxBuffers_.find(*pit);
+        if (it != harqTxBuffers_.end())
+            it->second->sendSelectedDown();
+    }
 }
 
 
@@ -19,6 +19,15 @@ class LteMacEnbRealistic : public LteMacEnb
     /// List of scheduled users - Downlink
     LteMacScheduleList* scheduleListDl_;
 
+    /// True if the served UEs have a downlink full-buffer connection
+    bool fullBufferDl_;
+
+    /// UEs having a full-buffer connection
+    std::set<MacNodeId> fullBufferUes_;
+
+    /// Binder forwarding version fullBufferUes_ was built at
+    unsigned int fullBufferVersion_;
+
     /**
      * Reads MAC parameters for eNb and performs initialization.
      */
@@ -45,6 +54,19 @@ class LteMacEnbRealistic : public LteMacEnb
      */
     virtual void macPduMake(MacCid cid);
 
+    /**
+     * Creates the full-buffer connections of the UEs attached to
+     * the cell (after an attach or a handover) and restores their
+     * backlog, so that they are always eligible for scheduling
+     */
+    void updateFullBufferConnections();
+
+    /**
+     * Synthesizes the MAC SDUs of a full-buffer connection, for a
+     * total size of sduSize bytes split over numSdus SDUs
+     */
+    void makeFullBufferSdus(MacCid cid, unsigned int numSdus, unsigned int sduSize);
+
 
     /**
      * bufferizePacket() is called every time a packet is
@@ -198,24 +198,15 @@ void LteMacEnbRealisticD2D::sendGrants(LteMacScheduleList* scheduleList)
         Direction dir = (lcid == D2D_MULTI_SHORT_BSR) ? D2D_MULTI : ((lcid == D2D_SHORT_BSR) ? D2D : UL);
 
         // TODO Grant is set aperiodic as default
-        LteSchedulingGrant* grant = new LteSchedulingGrant("LteGrant");
+        LteSchedulingGrant* grant = createGrant(nodeId);
         grant->setDirection(dir);
         grant->setCodewords(codewords);
 
         // set total granted blocks
         grant->setTotalGrantedBlocks(granted);
 
-        UserControlInfo* uinfo = new UserControlInfo();
-        uinfo->setSourceId(getMacNodeId());
-        uinfo->setDestId(nodeId);
-        uinfo->setFrameType(GRANTPKT);
-
-        grant->setControlInfo(uinfo);
-
         const UserTxParams& ui = getAmc()->computeTxParams(nodeId, dir);
-        UserTxParams* txPara = new UserTxParams(ui);
-        // FIXME: possible memory leak
-        grant->setUserTxParams(txPara);
+        grant->copyUserTxParams(ui);
 
         // acquiring remote antennas set from user info
         const std::set<Remote>& antennas = ui.readAntennaSet();
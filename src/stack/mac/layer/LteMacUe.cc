@@ -8,6 +8,7 @@
 //
 
 #include "LteMacUe.h"
+#include "LteMacEnb.h"
 #include "LteHarqBufferRx.h"
 #include "LteMacQueue.h"
 #include "LteSchedulingGrant.h"
@@ -34,6 +35,7 @@ LteMacUe::LteMacUe() :
     expirationCounter_ = 0;
     racRequested_ = false;
     bsrTriggered_ = false;
+    fullBufferRxBytes_ = 0;
 
     // TODO setup from NED
     racBackoffTimer_ = 0;
@@ -290,6 +292,13 @@ void LteMacUe::macPduMake(LteMacScheduleList* scheduleList)
     }
 }
 
+void LteMacUe::finish()
+{
+    LteMacBase::finish();
+    if (fullBufferRxBytes_ > 0)
+        recordScalar("fullBufferRxBytes", fullBufferRxBytes_);
+}
+
 void LteMacUe::macPduUnmake(cPacket* pkt)
 {
     LteMacPdu* macPkt = check_and_cast<LteMacPdu*>(pkt);
@@ -304,6 +313,15 @@ void LteMacUe::macPduUnmake(cPacket* pkt)
 
         // store descriptor for the incoming connection, if not already stored
         FlowControlInfo* lteInfo = check_and_cast<FlowControlInfo*>(upPkt->getControlInfo());
+
+        // full-buffer SDUs are synthesized by the eNB MAC: account them, there is nothing to reassemble
+        if (lteInfo->getLcid() == FULL_BUFFER_LCID)
+        {
+            fullBufferRxBytes_ += upPkt->getByteLength();
+            delete upPkt;
+            continue;
+        }
+
         MacNodeId senderId = lteInfo->getSourceId();
         LogicalCid lcid = lteInfo->getLcid();
         MacCid cid = idToMacCid(senderId, lcid);
@@ -365,8 +383,7 @@ void LteMacUe::handleSelfMessage()
         if(--expirationCounter_ < 0)
         {
             // Periodic grant is expired
-            delete schedulingGrant_;
-            schedulingGrant_ = NULL;
+            releaseGrant();
             // if necessary, a RAC request will be sent to obtain a grant
             checkRAC();
             //return;
@@ -456,10 +473,7 @@ void LteMacUe::handleSelfMessage()
 
         // deleting non-periodic grant
         if (!schedulingGrant_->getPeriodic())
-        {
-            delete schedulingGrant_;
-            schedulingGrant_=NULL;
-        }
+            releaseGrant();
     }
 
     //============================ DEBUG ==========================
@@ -508,11 +522,7 @@ LteMacUe::macHandleGrant(cPacket* pkt)
 
     //Codeword cw = grant->getCodeword();
 
-    if (schedulingGrant_!=NULL)
-    {
-        delete schedulingGrant_;
-        schedulingGrant_ = NULL;
-    }
+    releaseGrant();
 
     // store received grant
     schedulingGrant_=grant;
@@ -568,7 +578,47 @@ LteMacUe::macHandleRac(cPacket* pkt)
             EV << NOW << " Ue " << nodeId_ << " RAC attempt failed, backoff extracted : " << racBackoffTimer_ << endl;
         }
     }
-    delete racPkt;
+    // the response is the request sent by this UE: reuse it for the next one
+    racPool_.put(racPkt);
+}
+
+LteRac* LteMacUe::createRacRequest()
+{
+    LteRac* racReq = racPool_.get();
+    UserControlInfo* uinfo;
+    if (racReq == NULL)
+    {
+        racReq = new LteRac("RacRequest");
+        uinfo = new UserControlInfo();
+        racReq->setControlInfo(uinfo);
+    }
+    else
+    {
+        // RAC requests are pooled along with their control info
+        racReq->setSuccess(false);
+        uinfo = check_and_cast<UserControlInfo*>(racReq->getControlInfo());
+        uinfo->reset();
+    }
+    uinfo->setSourceId(getMacNodeId());
+    uinfo->setDestId(getMacCellId());
+    uinfo->setDirection(UL);
+    uinfo->setFrameType(RACPKT);
+    return racReq;
+}
+
+void LteMacUe::releaseGrant()
+{
+    if (schedulingGrant_ == NULL)
+        return;
+
+    // the eNB may have left the simulation
+    UserControlInfo* uinfo = check_and_cast<UserControlInfo*>(schedulingGrant_->getControlInfo());
+    LteMacEnb* enb = dynamic_cast<LteMacEnb*>(getMacByMacNodeId(uinfo->getSourceId()));
+    if (enb != NULL)
+        enb->recycleGrant(schedulingGrant_);
+    else
+        delete schedulingGrant_;
+    schedulingGrant_ = NULL;
 }
 
 void
@@ -599,32 +649,15 @@ LteMacUe::checkRAC()
         return;
     }
 
-    bool trigger=false;
-
-    LteMacBufferMap::const_iterator it;
-
-    for (it = macBuffers_.begin(); it!=macBuffers_.end();++it)
-    {
-        if (!(it->second->isEmpty()))
-        {
-            trigger = true;
-            break;
-        }
-    }
+    // the ready list holds the connections with data in their buffers
+    bool trigger = !lcgReadyList_.empty();
 
     if (!trigger)
     EV << NOW << "Ue " << nodeId_ << ",RAC aborted, no data in queues " << endl;
 
     if ((racRequested_=trigger))
     {
-        LteRac* racReq = new LteRac("RacRequest");
-        UserControlInfo* uinfo = new UserControlInfo();
-        uinfo->setSourceId(getMacNodeId());
-        uinfo->setDestId(getMacCellId());
-        uinfo->setDirection(UL);
-        uinfo->setFrameType(RACPKT);
-        racReq->setControlInfo(uinfo);
-
+        LteRac* racReq = createRacRequest();
         sendLowerPackets(racReq);
 
         EV << NOW << " Ue  " << nodeId_ << " cell " << cellId_ << " ,RAC request sent to PHY " << endl;
@@ -656,40 +689,25 @@ LteMacUe::updateUserTxParam(cPacket* pkt)
 bool
 LteMacUe::getHighestBackloggedFlow(MacCid& cid, unsigned int& priority)
 {
-    // TODO : optimize if inefficient
-    // TODO : implement priorities and LCGs
-    // search in virtual buffer structures
+    // the ready list is sorted by LCG priority
+    if (lcgReadyList_.empty())
+        return false;
 
-    LteMacBufferMap::const_iterator it = macBuffers_.begin(), et = macBuffers_.end();
-    for (; it != et; ++it)
-    {
-        if (!it->second->isEmpty())
-        {
-            cid = it->first;
-            // TODO priority = something;
-            return true;
-        }
-    }
-    return false;
+    cid = lcgReadyList_.begin()->second.first;
+    priority = lcgReadyList_.begin()->first.first;
+    return true;
 }
 
 bool
 LteMacUe::getLowestBackloggedFlow(MacCid& cid, unsigned int& priority)
 {
-    // TODO : optimize if inefficient
-    // TODO : implement priorities and LCGs
-    LteMacBufferMap::const_reverse_iterator it = macBuffers_.rbegin(), et = macBuffers_.rend();
-    for (; it != et; ++it)
-    {
-        if (!it->second->isEmpty())
-        {
-            cid = it->first;
-            // TODO priority = something;
-            return true;
-        }
-    }
+    // the ready list is sorted by LCG priority
+    if (lcgReadyList_.empty())
+        return false;
 
-    return false;
+    cid = lcgReadyList_.rbegin()->second.first;
+    priority = lcgReadyList_.rbegin()->first.first;
+    return true;
 }
 
 void LteMacUe::doHandover(MacNodeId targetEnb)
@@ -735,5 +753,7 @@ void LteMacUe::deleteQueues(MacNodeId nodeId)
 
     // remove traffic descriptor and lcg entry
     lcgMap_.clear();
+    lcgReadyList_.clear();
+    lcgRank_.clear();
     connDesc_.clear();
 }
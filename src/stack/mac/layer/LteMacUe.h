@@ -12,8 +12,10 @@
 
 #include "LteMacBase.h"
 #include "LteHarqBufferTx.h"
+#include "LteMessagePool.h"
 
 class LteSchedulingGrant;
+class LteRac;
 class LteSchedulerUeUl;
 class LteBinder;
 
@@ -47,14 +49,25 @@ class LteMacUe : public LteMacBase
     unsigned int raRespTimer_;
     unsigned int raRespWinStart_;
 
+    // RAC requests, reused once the eNB response has been handled
+    LteMessagePool<LteRac> racPool_;
+
     // BSR handling
     bool bsrTriggered_;
 
+    // bytes received on full-buffer connections (see LteMacEnbRealistic)
+    unsigned long fullBufferRxBytes_;
+
     /**
      * Reads MAC parameters for ue and performs initialization.
      */
     virtual void initialize(int stage);
 
+    /**
+     * Records the bytes received on full-buffer connections, if any
+     */
+    virtual void finish();
+
     /**
      * macPduMake() creates MAC PDUs (one for each CID)
      * by extracting SDUs from Real Mac Buffers according
@@ -93,6 +106,18 @@ class LteMacUe : public LteMacBase
      * Checks RAC status
      */
     virtual void checkRAC();
+
+    /*
+     * Returns a RAC request towards the serving cell, reusing
+     * one of the handled RAC responses if available
+     */
+    LteRac* createRacRequest();
+
+    /*
+     * Gives the current grant back to the eNB that sent it
+     * (see LteMacEnb::recycleGrant()) and clears it
+     */
+    void releaseGrant();
     /*
      * Update UserTxParam stored in every lteMacPdu when an rtx change this information
      */
@@ -172,8 +172,7 @@ void LteMacUeD2D::handleSelfMessage()
         if(--expirationCounter_ < 0)
         {
             // Periodic grant is expired
-            delete schedulingGrant_;
-            schedulingGrant_ = NULL;
+            releaseGrant();
             // if necessary, a RAC request will be sent to obtain a grant
             checkRAC();
             //return;
@@ -265,10 +264,7 @@ void LteMacUeD2D::handleSelfMessage()
 
         // deleting non-periodic grant
         if (!schedulingGrant_->getPeriodic())
-        {
-            delete schedulingGrant_;
-            schedulingGrant_=NULL;
-        }
+            releaseGrant();
     }
 
     //============================ DEBUG ==========================
@@ -680,18 +676,7 @@ void LteMacUeD2D::macHandleD2DModeSwitch(cPacket* pkt)
                     connDesc_.erase(it++);
 
                     // remove entry from lcgMap
-                    LcgMap::iterator lt = lcgMap_.begin();
-                    for (; lt != lcgMap_.end(); )
-                    {
-                        if (lt->second.first == cid)
-                        {
-                            lcgMap_.erase(lt++);
-                        }
-                        else
-                        {
-                            ++lt;
-                        }
-                    }
+                    removeLcgConnection(cid);
                 }
                 else
                 {
@@ -823,14 +808,7 @@ void LteMacUeD2D::checkRAC()
 
     if ((racRequested_=trigger) || (racD2DMulticastRequested_=triggerD2DMulticast))
     {
-        LteRac* racReq = new LteRac("RacRequest");
-        UserControlInfo* uinfo = new UserControlInfo();
-        uinfo->setSourceId(getMacNodeId());
-        uinfo->setDestId(getMacCellId());
-        uinfo->setDirection(UL);
-        uinfo->setFrameType(RACPKT);
-        racReq->setControlInfo(uinfo);
-
+        LteRac* racReq = createRacRequest();
         sendLowerPackets(racReq);
 
         EV << NOW << " Ue  " << nodeId_ << " cell " << cellId_ << " ,RAC request sent to PHY " << endl;
@@ -881,7 +859,8 @@ void LteMacUeD2D::macHandleRac(cPacket* pkt)
             EV << NOW << " Ue " << nodeId_ << " RAC attempt failed, backoff extracted : " << racBackoffTimer_ << endl;
         }
     }
-    delete racPkt;
+    // the response is the request sent by this UE: reuse it for the next one
+    racPool_.put(racPkt);
 }
 
 void LteMacUeD2D::doHandover(MacNodeId targetEnb)
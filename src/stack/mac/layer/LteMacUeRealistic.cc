@@ -322,7 +322,7 @@ bool LteMacUeRealistic::bufferizePacket(cPacket* pkt)
             // register connection to lcg map.
             LteTrafficClass tClass = (LteTrafficClass) lteInfo->getTraffic();
 
-            lcgMap_.insert(LcgPair(tClass, CidBufferPair(cid, macBuffers_[cid])));
+            addLcgConnection(tClass, cid, vqueue);
 
             EV << "LteMacBuffers : Using new buffer on node: " <<
             MacCidToNodeId(cid) << " for Lcid: " << MacCidToLcid(cid) << ", Bytes in the Queue: " <<
@@ -332,6 +332,7 @@ bool LteMacUeRealistic::bufferizePacket(cPacket* pkt)
         {
             LteMacBuffer* vqueue = macBuffers_.find(cid)->second;
             vqueue->pushBack(vpkt);
+            updateBufferStatus(cid);
 
             EV << "LteMacBuffers : Using old buffer on node: " <<
             MacCidToNodeId(cid) << " for Lcid: " << MacCidToLcid(cid) << ", Space left in the Queue: " <<
@@ -458,8 +459,7 @@ void LteMacUeRealistic::handleSelfMessage()
         if(--expirationCounter_ < 0)
         {
             // Periodic grant is expired
-            delete schedulingGrant_;
-            schedulingGrant_ = NULL;
+            releaseGrant();
             // if necessary, a RAC request will be sent to obtain a grant
             checkRAC();
             //return;
@@ -616,8 +616,5 @@ void LteMacUeRealistic::flushHarqBuffers()
 
     // deleting non-periodic grant
     if (schedulingGrant_ != NULL && !schedulingGrant_->getPeriodic())
-    {
-        delete schedulingGrant_;
-        schedulingGrant_=NULL;
-    }
+        releaseGrant();
 }
@@ -62,7 +62,7 @@ LteMacPdu* LteMacUeRealisticD2D::makeBsr(int size){
     uinfo->setSourceId(getMacNodeId());
     uinfo->setDestId(getMacCellId());
     uinfo->setDirection(UL);
-    uinfo->setUserTxParams(schedulingGrant_->getUserTxParams());
+    uinfo->setUserTxParams(schedulingGrant_->getUserTxParams()->dup());
     LteMacPdu* macPkt = new LteMacPdu("LteMacPdu");
     macPkt->setHeaderLength(MAC_HEADER);
     macPkt->setControlInfo(uinfo);
@@ -87,12 +87,14 @@ void LteMacUeRealisticD2D::macPduMake()
     if ((bsrTriggered_ || bsrD2DMulticastTriggered_) && schedulingGrant_->getDirection() == UL && scheduleList_->empty())
     {
         // Compute BSR size taking into account only DM flows
+        // (only the backlogged connections contribute to the BSR)
         int sizeBsr = 0;
-        LteMacBufferMap::const_iterator itbsr;
-        for (itbsr = macBuffers_.begin(); itbsr != macBuffers_.end(); itbsr++)
+        LcgReadyList::const_iterator itbsr;
+        for (itbsr = lcgReadyList_.begin(); itbsr != lcgReadyList_.end(); itbsr++)
         {
-            MacCid cid = itbsr->first;
-            Direction connDir = (Direction)connDesc_[cid].getDirection();
+            MacCid cid = itbsr->second.first;
+            const FlowControlInfo& connInfo = connDesc_[cid];
+            Direction connDir = (Direction)connInfo.getDirection();
 
             // if the bsr was triggered by D2D (D2D_MULTI), only account for D2D (D2D_MULTI) connections
             if (bsrTriggered_ && connDir != D2D)
@@ -100,16 +102,13 @@ void LteMacUeRealisticD2D::macPduMake()
             if (bsrD2DMulticastTriggered_ && connDir != D2D_MULTI)
                 continue;
 
-            sizeBsr += itbsr->second->getQueueOccupancy();
+            sizeBsr += itbsr->second.second->getQueueOccupancy();
 
             // take into account the RLC header size
-            if (sizeBsr > 0)
-            {
-                if (connDesc_[cid].getRlcType() == UM)
-                    sizeBsr += RLC_HEADER_UM;
-                else if (connDesc_[cid].getRlcType() == AM)
-                    sizeBsr += RLC_HEADER_AM;
-            }
+            if (connInfo.getRlcType() == UM)
+                sizeBsr += RLC_HEADER_UM;
+            else if (connInfo.getRlcType() == AM)
+                sizeBsr += RLC_HEADER_AM;
         }
 
         if (sizeBsr > 0)
@@ -411,11 +410,7 @@ LteMacUeRealisticD2D::macHandleGrant(cPacket* pkt)
 
     //Codeword cw = grant->getCodeword();
 
-    if (schedulingGrant_!=NULL)
-    {
-        delete schedulingGrant_;
-        schedulingGrant_ = NULL;
-    }
+    releaseGrant();
 
     // store received grant
     schedulingGrant_=grant;
@@ -497,8 +492,7 @@ void LteMacUeRealisticD2D::handleSelfMessage()
         if(--expirationCounter_ < 0)
         {
             // Periodic grant is expired
-            delete schedulingGrant_;
-            schedulingGrant_ = NULL;
+            releaseGrant();
             // if necessary, a RAC request will be sent to obtain a grant
             checkRAC();
         }
@@ -705,106 +699,95 @@ void LteMacUeRealisticD2D::macHandleD2DModeSwitch(cPacket* pkt)
     LteD2DMode oldMode = switchPkt->getOldMode();
     UserControlInfo* uInfo = check_and_cast<UserControlInfo*>(pkt->removeControlInfo());
 
+    // descriptor of a connection involved in the switch, used to deliver the notification to the RLC
+    FlowControlInfo* notifyInfo = NULL;
+
     if (txSide)
     {
         Direction newDirection = (newMode == DM) ? D2D : UL;
         Direction oldDirection = (oldMode == DM) ? D2D : UL;
+        bool interruptHarq = false;
 
-        // find the correct connection involved in the mode switch
-        MacCid cid;
-        FlowControlInfo* lteInfo = NULL;
-        std::map<MacCid, FlowControlInfo>::iterator it = connDesc_.begin();
-        for (; it != connDesc_.end(); ++it)
+        // only the connections towards the peer are involved in the mode switch
+        PeerConnections::const_iterator pit = peerConnDesc_.find(peerId);
+        if (pit != peerConnDesc_.end())
         {
-            cid = it->first;
-            lteInfo = check_and_cast<FlowControlInfo*>(&(it->second));
-
-            if (lteInfo->getD2dRxPeerId() == peerId && (Direction)lteInfo->getDirection() == oldDirection)
+            std::vector<MacCid>::const_iterator it = pit->second.begin();
+            for (; it != pit->second.end(); ++it)
             {
-                EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found old connection with cid " << cid << ", erasing buffered data" << endl;
-                if (oldDirection != newDirection)
-                {
-                    // empty virtual buffer for the selected cid
-                    LteMacBufferMap::iterator macBuff_it = macBuffers_.find(cid);
-                    if (macBuff_it != macBuffers_.end())
-                    {
-                        while (!(macBuff_it->second->isEmpty()))
-                            macBuff_it->second->popFront();
-                        delete macBuff_it->second;
-                        macBuffers_.erase(macBuff_it);
-                    }
+                MacCid cid = *it;
+                std::map<MacCid, FlowControlInfo>::iterator dit = connDesc_.find(cid);
+                if (dit == connDesc_.end())
+                    continue;
+                FlowControlInfo* lteInfo = &(dit->second);
 
-                    // empty real buffer for the selected cid (they should be already empty)
-                    LteMacBuffers::iterator mBuf_it = mbuf_.find(cid);
-                    if (mBuf_it != mbuf_.end())
+                if ((Direction)lteInfo->getDirection() == oldDirection)
+                {
+                    EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found old connection with cid " << cid << ", erasing buffered data" << endl;
+                    if (oldDirection != newDirection)
                     {
-                        while (mBuf_it->second->getQueueLength() > 0)
+                        // empty virtual buffer for the selected cid
+                        LteMacBufferMap::iterator macBuff_it = macBuffers_.find(cid);
+                        if (macBuff_it != macBuffers_.end())
                         {
-                            cPacket* pdu = mBuf_it->second->popFront();
-                            delete pdu;
+                            while (!(macBuff_it->second->isEmpty()))
+                                macBuff_it->second->popFront();
+                            delete macBuff_it->second;
+                            macBuffers_.erase(macBuff_it);
                         }
-                        delete mBuf_it->second;
-                        mbuf_.erase(mBuf_it);
-                    }
 
-                    // interrupt H-ARQ processes for SL
-                    unsigned int id = peerId;
-                    HarqTxBuffers::iterator hit = harqTxBuffers_.find(id);
-                    if (hit != harqTxBuffers_.end())
-                    {
-                        for (int proc = 0; proc < (unsigned int) UE_TX_HARQ_PROCESSES; proc++)
+                        // empty real buffer for the selected cid (they should be already empty)
+                        LteMacBuffers::iterator mBuf_it = mbuf_.find(cid);
+                        if (mBuf_it != mbuf_.end())
                         {
-                            hit->second->forceDropProcess(proc);
+                            while (mBuf_it->second->getQueueLength() > 0)
+                            {
+                                cPacket* pdu = mBuf_it->second->popFront();
+                                delete pdu;
+                            }
+                            delete mBuf_it->second;
+                            mbuf_.erase(mBuf_it);
                         }
-                    }
 
-                    // interrupt H-ARQ processes for UL
-                    id = getMacCellId();
-                    hit = harqTxBuffers_.find(id);
-                    if (hit != harqTxBuffers_.end())
-                    {
-                        for (int proc = 0; proc < (unsigned int) UE_TX_HARQ_PROCESSES; proc++)
-                        {
-                            hit->second->forceDropProcess(proc);
-                        }
+                        // remove entry from lcgMap
+                        removeLcgConnection(cid);
+
+                        interruptHarq = true;
                     }
-                }
 
-                // abort BSR requests
-                bsrTriggered_ = false;
+                    // abort BSR requests
+                    bsrTriggered_ = false;
 
-                D2DModeSwitchNotification* switchPkt_dup = switchPkt->dup();
-                switchPkt_dup->setControlInfo(lteInfo->dup());
-                switchPkt_dup->setOldConnection(true);
-                sendUpperPackets(switchPkt_dup);
+                    notifyInfo = lteInfo;
+                }
+                else if ((Direction)lteInfo->getDirection() == newDirection && oldDirection != newDirection)
+                {
+                    EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found new connection with cid " << cid << endl;
+                    if (notifyInfo == NULL)
+                        notifyInfo = lteInfo;
+                }
+            }
+        }
 
-                if (oldDirection != newDirection)
+        if (interruptHarq)
+        {
+            // interrupt H-ARQ processes for SL
+            HarqTxBuffers::iterator hit = harqTxBuffers_.find(peerId);
+            if (hit != harqTxBuffers_.end())
+            {
+                for (int proc = 0; proc < (unsigned int) UE_TX_HARQ_PROCESSES; proc++)
                 {
-                    // remove entry from lcgMap
-                    LcgMap::iterator lt = lcgMap_.begin();
-                    for (; lt != lcgMap_.end(); )
-                    {
-                        if (lt->second.first == cid)
-                        {
-                            lcgMap_.erase(lt++);
-                        }
-                        else
-                        {
-                            ++lt;
-                        }
-                    }
+                    hit->second->forceDropProcess(proc);
                 }
-                EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - send switch signal to the RLC TX entity corresponding to the old mode, cid " << cid << endl;
             }
-            else if (lteInfo->getD2dRxPeerId() == peerId && (Direction)lteInfo->getDirection() == newDirection)
+
+            // interrupt H-ARQ processes for UL
+            hit = harqTxBuffers_.find(getMacCellId());
+            if (hit != harqTxBuffers_.end())
             {
-                EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - send switch signal to the RLC TX entity corresponding to the new mode, cid " << cid << endl;
-                if (oldDirection != newDirection)
+                for (int proc = 0; proc < (unsigned int) UE_TX_HARQ_PROCESSES; proc++)
                 {
-                    D2DModeSwitchNotification* switchPkt_dup = switchPkt->dup();
-                    switchPkt_dup->setOldConnection(false);
-                    switchPkt_dup->setControlInfo(lteInfo->dup());
-                    sendUpperPackets(switchPkt_dup);
+                    hit->second->forceDropProcess(proc);
                 }
             }
         }
@@ -813,60 +796,111 @@ void LteMacUeRealisticD2D::macHandleD2DModeSwitch(cPacket* pkt)
     {
         Direction newDirection = (newMode == DM) ? D2D : DL;
         Direction oldDirection = (oldMode == DM) ? D2D : DL;
+        bool interruptHarq = false;
 
-        // find the correct connection involved in the mode switch
-        MacCid cid;
-        FlowControlInfo* lteInfo = NULL;
-        std::map<MacCid, FlowControlInfo>::iterator it = connDescIn_.begin();
-        for (; it != connDescIn_.end(); ++it)
+        // only the connections from the peer are involved in the mode switch
+        PeerConnections::const_iterator pit = peerConnDescIn_.find(peerId);
+        if (pit != peerConnDescIn_.end() && oldDirection != newDirection)
         {
-            cid = it->first;
-            lteInfo = check_and_cast<FlowControlInfo*>(&(it->second));
-            if (lteInfo->getD2dTxPeerId() == peerId && (Direction)lteInfo->getDirection() == oldDirection)
+            std::vector<MacCid>::const_iterator it = pit->second.begin();
+            for (; it != pit->second.end(); ++it)
             {
-                EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found old connection with cid " << cid << ", send signal to the RLC RX entity" << endl;
-                if (oldDirection != newDirection)
-                {
-                    // interrupt H-ARQ processes for SL
-                    unsigned int id = peerId;
-                    HarqRxBuffers::iterator hit = harqRxBuffers_.find(id);
-                    if (hit != harqRxBuffers_.end())
-                    {
-                        for (unsigned int proc = 0; proc < (unsigned int) UE_RX_HARQ_PROCESSES; proc++)
-                        {
-                            unsigned int numUnits = hit->second->getProcess(proc)->getNumHarqUnits();
-                            for (unsigned int i=0; i < numUnits; i++)
-                            {
+                MacCid cid = *it;
+                std::map<MacCid, FlowControlInfo>::iterator dit = connDescIn_.find(cid);
+                if (dit == connDescIn_.end())
+                    continue;
+                FlowControlInfo* lteInfo = &(dit->second);
 
-                                hit->second->getProcess(proc)->purgeCorruptedPdu(i); // delete contained PDU
-                                hit->second->getProcess(proc)->resetCodeword(i);     // reset unit
-                            }
-                        }
-                    }
-                    enb_->deleteRxHarqBufferMirror(nodeId_);
-
-                    // notify that this UE is switching during this TTI
-                    resetHarq_[peerId] = NOW;
-
-                    D2DModeSwitchNotification* switchPkt_dup = switchPkt->dup();
-                    switchPkt_dup->setControlInfo(lteInfo->dup());
-                    switchPkt_dup->setOldConnection(true);
-                    sendUpperPackets(switchPkt_dup);
+                if ((Direction)lteInfo->getDirection() == oldDirection)
+                {
+                    EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found old connection with cid " << cid << endl;
+                    interruptHarq = true;
+                    notifyInfo = lteInfo;
+                }
+                else if ((Direction)lteInfo->getDirection() == newDirection)
+                {
+                    EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found new connection with cid " << cid << endl;
+                    if (notifyInfo == NULL)
+                        notifyInfo = lteInfo;
                 }
             }
-            else if (lteInfo->getD2dTxPeerId() == peerId && (Direction)lteInfo->getDirection() == newDirection)
+        }
+
+        if (interruptHarq)
+        {
+            // interrupt H-ARQ processes for SL
+            HarqRxBuffers::iterator hit = harqRxBuffers_.find(peerId);
+            if (hit != harqRxBuffers_.end())
             {
-                EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - found new connection with cid " << cid << ", send signal to the RLC RX entity" << endl;
-                if (oldDirection != newDirection)
+                for (unsigned int proc = 0; proc < (unsigned int) UE_RX_HARQ_PROCESSES; proc++)
                 {
-                    D2DModeSwitchNotification* switchPkt_dup = switchPkt->dup();
-                    switchPkt_dup->setOldConnection(false);
-                    switchPkt_dup->setControlInfo(lteInfo->dup());
-                    sendUpperPackets(switchPkt_dup);
+                    unsigned int numUnits = hit->second->getProcess(proc)->getNumHarqUnits();
+                    for (unsigned int i=0; i < numUnits; i++)
+                    {
+
+                        hit->second->getProcess(proc)->purgeCorruptedPdu(i); // delete contained PDU
+                        hit->second->getProcess(proc)->resetCodeword(i);     // reset unit
+                    }
                 }
             }
+            enb_->deleteRxHarqBufferMirror(nodeId_);
+
+            // notify that this UE is switching during this TTI
+            resetHarq_[peerId] = NOW;
         }
     }
     delete uInfo;
-    delete pkt;
+
+    if (notifyInfo != NULL)
+    {
+        // the same notification is forwarded to the RLC, which dispatches it
+        // to all its entities associated to the peer
+        EV << NOW << " LteMacUeRealisticD2D::macHandleD2DModeSwitch - send switch signal to the RLC entities for peer " << peerId << endl;
+        switchPkt->setControlInfo(notifyInfo->dup());
+        sendUpperPackets(switchPkt);
+    }
+    else
+    {
+        delete switchPkt;
+    }
+}
+
+bool LteMacUeRealisticD2D::bufferizePacket(cPacket* pkt)
+{
+    unsigned int connections = connDesc_.size();
+    bool result = LteMacUeRealistic::bufferizePacket(pkt);
+
+    // a new outgoing connection has been stored
+    if (connDesc_.size() != connections)
+        indexPeerConnections();
+
+    return result;
+}
+
+void LteMacUeRealisticD2D::macPduUnmake(cPacket* pkt)
+{
+    unsigned int connections = connDescIn_.size();
+    LteMacUeRealistic::macPduUnmake(pkt);
+
+    // a new incoming connection has been stored
+    if (connDescIn_.size() != connections)
+        indexPeerConnections();
+}
+
+void LteMacUeRealisticD2D::indexPeerConnections()
+{
+    peerConnDesc_.clear();
+    peerConnDescIn_.clear();
+
+    std::map<MacCid, FlowControlInfo>::const_iterator it;
+    for (it = connDesc_.begin(); it != connDesc_.end(); ++it)
+    {
+        if (it->second.getD2dRxPeerId() != 0)
+            peerConnDesc_[it->second.getD2dRxPeerId()].push_back(it->first);
+    }
+    for (it = connDescIn_.begin(); it != connDescIn_.end(); ++it)
+    {
+        if (it->second.getD2dTxPeerId() != 0)
+            peerConnDescIn_[it->second.getD2dTxPeerId()].push_back(it->first);
+    }
 }
@@ -33,6 +33,17 @@ class LteMacUeRealisticD2D : public LteMacUeRealistic
     UserTxParams* preconfiguredTxParams_;
     UserTxParams* getPreconfiguredTxParams();  // build and return new user tx params
 
+    /*
+     * Connections indexed by D2D peer: outgoing connections by receiving peer,
+     * incoming connections by transmitting peer. Used to handle mode switches
+     */
+    typedef std::map<MacNodeId, std::vector<MacCid> > PeerConnections;
+    PeerConnections peerConnDesc_;
+    PeerConnections peerConnDescIn_;
+
+    // rebuilds the peer indices from the connection descriptors
+    void indexPeerConnections();
+
   protected:
 
     /**
@@ -53,8 +64,23 @@ class LteMacUeRealisticD2D : public LteMacUeRealistic
 
     virtual void macHandleGrant(cPacket* pkt);
 
+    /**
+     * Handles a mode switch towards a D2D peer: only the connections and
+     * the H-ARQ buffers of that peer are involved, and a single notification
+     * is forwarded to the upper layers
+     */
     void macHandleD2DModeSwitch(cPacket* pkt);
 
+    /**
+     * Bufferizes the packet and indexes the new connections by D2D peer
+     */
+    virtual bool bufferizePacket(cPacket* pkt);
+
+    /**
+     * Extracts the SDUs and indexes the new incoming connections by D2D peer
+     */
+    virtual void macPduUnmake(cPacket* pkt);
+
     virtual LteMacPdu* makeBsr(int size);
 
     /**
@@ -95,6 +95,7 @@ class LteMacPdu : public LteMacPdu_Base
         }
 
         // duplicate control info - if it exists
+        delete removeControlInfo();
         cObject* ci = other.getControlInfo();
         if(ci){
             UserControlInfo * uci = dynamic_cast<UserControlInfo *> (other.getControlInfo());
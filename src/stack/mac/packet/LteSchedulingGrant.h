@@ -82,6 +82,35 @@ class LteSchedulingGrant : public LteSchedulingGrant_Base
         return userTxParams;
     }
 
+    /**
+     * Copies the given parameters in the grant, reusing the
+     * UserTxParams object already held by the grant, if any
+     */
+    void copyUserTxParams(const UserTxParams& params)
+    {
+        if (userTxParams != NULL)
+            *const_cast<UserTxParams*>(userTxParams) = params;
+        else
+            userTxParams = new UserTxParams(params);
+    }
+
+    /**
+     * Restores the default values of a delivered grant, so that it
+     * can be sent again. The control info and the UserTxParams object
+     * are kept, to be overwritten by the sender
+     */
+    void reset()
+    {
+        setPeriodic(false);
+        setPeriod(0);
+        setExpiration(0);
+        setTotalGrantedBlocks(0);
+        setCodewords(0);
+        grantedBlocks.clear();
+        grantedCwBytes.assign(MAX_CODEWORDS, 0);
+        direction_ = UL;
+    }
+
     const unsigned int getBlocks(Remote antenna, Band b) const
         {
         return grantedBlocks.at(antenna).at(b);
@@ -19,7 +19,8 @@ class LteMacPdu;
 /**
  * @class LcgScheduler
  */
-typedef std::map<MacCid, unsigned int> ScheduleList;
+/// Number of scheduled SDUs per cid, in service order (at most one entry per cid)
+typedef std::vector<std::pair<MacCid, unsigned int> > ScheduleList;
 
 class LcgScheduler
 {
@@ -68,14 +69,12 @@ class LcgScheduler
     LteSchedulerUeUl* ueScheduler_;
 
     // schedule List - returned by reference on scheduler invocation
+    // (reused across invocations, so that it keeps its capacity)
     ScheduleList scheduleList_;
 
     /// Cid List
     typedef std::list<MacCid> CidList;
 
-    // scheduling status map
-    std::map<MacCid, StatusElem> statusMap_;
-
   public:
 
     /**
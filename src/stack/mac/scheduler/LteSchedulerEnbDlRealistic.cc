@@ -43,32 +43,25 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
 
     std::string bands_msg = "BAND_LIMIT_SPECIFIED";
 
-    std::vector<BandLimit> tempBandLim;
-
     if (bandLim == NULL)
     {
         bands_msg = "NO_BAND_SPECIFIED";
-        // Create a vector of band limit using all bands
-        bandLim = &tempBandLim;
+        // Use a vector of band limit covering all bands
+        bandLim = &allBandLim_;
 
         txParams.print("grant()");
 
         unsigned int numBands = mac_->getDeployer()->getNumBands();
-        // for each band of the band vector provided
-        for (unsigned int i = 0; i < numBands; i++)
+        if (allBandLim_.size() != numBands)
         {
-            BandLimit elem;
-            // copy the band
-            elem.band_ = Band(i);
-            EV << "Putting band " << i << endl;
-            // mark as unlimited
-            for (unsigned int j = 0; j < numCodewords; j++)
-            {
-                EV << "- Codeword " << j << endl;
-                elem.limit_.push_back(-1);
-            }
-            bandLim->push_back(elem);
+            allBandLim_.clear();
+            allBandLim_.reserve(numBands);
+            for (unsigned int i = 0; i < numBands; i++)
+                allBandLim_.push_back(BandLimit(Band(i)));
         }
+        // mark all bands as unlimited, the previous grant may have modified the limits
+        for (unsigned int i = 0; i < numBands; i++)
+            std::fill(allBandLim_[i].limit_.begin(), allBandLim_[i].limit_.end(), -1);
     }
     EV << "LteSchedulerEnbDlRealistic::grant(" << cid << "," << bytes << "," << terminate << "," << active << "," << eligible << "," << bands_msg << "," << dasToA(antenna) << ")" << endl;
 
@@ -188,14 +181,16 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
 
         unsigned int allocatedCws = 0;
 
-        std::list<Request> bookedRequests;
-
-        // band limit structure
-
         EV << "LteSchedulerEnbDlRealistic::grant @@@@@ CODEWORD " << cw << " @@@@@" << endl;
 
         unsigned int size = (*bandLim).size();
 
+        // at most one request is booked per band
+        bookedRequests_.clear();
+        bookedBandIndex_.clear();
+        bookedRequests_.reserve(size);
+        bookedBandIndex_.reserve(size);
+
         unsigned int toBook;
         // Check whether the virtual buffer is empty
         if (queueLength == 0)
@@ -223,9 +218,6 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
         // Book bands for this connection
         for (unsigned int i = 0; i < size; ++i)
         {
-            // for sulle bande
-            unsigned int bandAllocatedBytes = 0;
-
             // save the band and the relative limit
             Band b = (*bandLim).at(i).band_;
             int limit = (*bandLim).at(i).limit_.at(cw);
@@ -301,18 +293,12 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
 
 
 
-            // book resources on this band
-
-            unsigned int blocksAdded = mac_->getAmc()->computeReqRbs(nodeId, b, cw, bandAllocatedBytes,
-                direction_);
-
-            if (blocksAdded > bandAvailableBlocks)
-                throw cRuntimeError("band %d GRANT allocation overflow : avail. blocks %d alloc. blocks %d", b,
-                    bandAvailableBlocks, blocksAdded);
+            // book resources on this band (nothing has been allocated on it yet, so all its available blocks are booked)
 
-            EV << "LteSchedulerEnbDlRealistic::grant Booking band available blocks" << (bandAvailableBlocks-blocksAdded) << " [" << bandAvailableBytes << " bytes] for future use, going to next band" << endl;
+            EV << "LteSchedulerEnbDlRealistic::grant Booking band available blocks" << bandAvailableBlocks << " [" << bandAvailableBytes << " bytes] for future use, going to next band" << endl;
             // enable booking  here
-            bookedRequests.push_back(Request(b, bandAvailableBytes, bandAvailableBlocks - blocksAdded));
+            bookedRequests_.push_back(Request(b, bandAvailableBytes, bandAvailableBlocks));
+            bookedBandIndex_.push_back(i);
 
 
             // update the counter of bytes to be served
@@ -334,11 +320,11 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
         unsigned int totalBooked = 0;
         unsigned int bookedUsed = 0;
 
-        std::list<Request>::iterator li = bookedRequests.begin(), le = bookedRequests.end();
-        for (; li != le; ++li)
+        unsigned int numBooked = bookedRequests_.size();
+        for (unsigned int k = 0; k < numBooked; ++k)
         {
-            totalBooked += li->bytes_;
-            EV << "LteSchedulerEnbDlRealistic::grant Band " << li->b_ << " can contribute with " << li->bytes_ << " of booked resources " << endl;
+            totalBooked += bookedRequests_[k].bytes_;
+            EV << "LteSchedulerEnbDlRealistic::grant Band " << bookedRequests_[k].b_ << " can contribute with " << bookedRequests_[k].bytes_ << " of booked resources " << endl;
         }
 
         // get resources to allocate
@@ -349,13 +335,11 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
         // decrease booking value - if totalBooked is greater than 0, we used booked resources for scheduling the pdu
         if (totalBooked>0)
         {
-            // reset booked resources iterator.
-            li=bookedRequests.begin();
-
             EV << "LteSchedulerEnbDlRealistic::grant Making use of booked resources [" << totalBooked << "] for inter-band data allocation" << endl;
             // updating booked requests structure
-            while ((li!=le) && (bookedUsed<=toServe))
+            for (unsigned int k = 0; (k < numBooked) && (bookedUsed<=toServe); ++k)
             {
+                Request* li = &bookedRequests_[k];
                 Band u = li->b_;
                 unsigned int uBytes = ((li->bytes_ > toServe )? toServe : li->bytes_ );
 
@@ -382,8 +366,7 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
                 // update limit
                 if (uBlocks>0)
                 {
-                    unsigned int j=0;
-                    for (;j<(*bandLim).size();++j) if ((*bandLim).at(j).band_==u) break;
+                    unsigned int j = bookedBandIndex_[k];
 
                     if((*bandLim).at(j).limit_.at(cw) > 0)
                     {
@@ -406,17 +389,9 @@ unsigned int LteSchedulerEnbDlRealistic::scheduleGrant(MacCid cid, unsigned int
                 if (li->bytes_>toServe)
                 {
                     li->bytes_-=toServe;
-
-                    li++;
                 }
                 else
                 {
-                    std::list<Request>::iterator erase = li;
-                    // increment pointer.
-                    li++;
-                    // erase element from list
-                    bookedRequests.erase(erase);
-
                     EV << "LteSchedulerEnbDlRealistic::grant band " << (unsigned short)u << " depleted all its booked resources " << endl;
                 }
             }
@@ -19,6 +19,20 @@
 class LteSchedulerEnbDlRealistic : public LteSchedulerEnbDl
 {
 
+protected:
+    /*
+     * Grant bookkeeping, preallocated and reused by every grant
+     */
+
+    // Band limits covering all the bands, used when no band limit is given to the grant
+    std::vector<BandLimit> allBandLim_;
+
+    // Resources booked on each band for the codeword being allocated
+    std::vector<Request> bookedRequests_;
+
+    // Position within the band limit vector of the band of each booked request
+    std::vector<unsigned int> bookedBandIndex_;
+
 public:
     LteSchedulerEnbDlRealistic();
     virtual ~LteSchedulerEnbDlRealistic();
@@ -26,12 +26,11 @@ LteSchedulerEnbUl::checkEligibility(MacNodeId id, Codeword& cw)
 
         // get current Harq Process for nodeId
         unsigned char currentAcid = harqStatus_.at(id);
-        // get current Harq Process status
-        std::vector<RxUnitStatus> status = ulHarq->getProcess(currentAcid)->getProcessStatus();
+        LteHarqProcessRx* currentProcess = ulHarq->getProcess(currentAcid);
         // check if at least one codeword buffer is available for reception
         for (; cw < MAX_CODEWORDS; ++cw)
         {
-            if (status.at(cw).second == RXHARQ_PDU_EMPTY)
+            if (currentProcess->getUnitStatus(cw) == RXHARQ_PDU_EMPTY)
             {
                 return true;
             }
@@ -141,21 +140,24 @@ LteSchedulerEnbUl::rtxschedule()
         EV << NOW << " LteSchedulerEnbUl::rtxschedule eNodeB: " << mac_->getMacCellId() << endl;
         EV << NOW << " LteSchedulerEnbUl::rtxschedule Direction: " << (direction_ == UL ? "UL" : "DL") << endl;
 
-        HarqRxBuffers::iterator it= harqRxBuffers_->begin() , et=harqRxBuffers_->end();
+        // only the UEs whose H-ARQ buffers hold pdus may need a retransmission
+        const std::set<MacNodeId>& pending = mac_->getHarqRxPending();
+        std::vector<MacNodeId> departed;
+        HarqRxBuffers::iterator it;
+        std::set<MacNodeId>::const_iterator nit = pending.begin(), net = pending.end();
 
-        for(; it != et; ++it)
+        for(; nit != net; ++nit)
         {
             // get current nodeId
-            MacNodeId nodeId = it->first;
+            MacNodeId nodeId = *nit;
 
-            if(nodeId == 0){
-                // UE has left the simulation - erase queue and continue
-                harqRxBuffers_->erase(nodeId);
+            it = harqRxBuffers_->find(nodeId);
+            if (it == harqRxBuffers_->end())
                 continue;
-            }
-            OmnetId id = getBinder()->getOmnetId(nodeId);
-            if(id == 0){
-                harqRxBuffers_->erase(nodeId);
+
+            if(nodeId == 0 || getBinder()->getOmnetId(nodeId) == 0){
+                // UE has left the simulation - erase queue (after the loop) and continue
+                departed.push_back(nodeId);
                 continue;
             }
 
@@ -166,11 +168,9 @@ LteSchedulerEnbUl::rtxschedule()
             bool skip = true;
             unsigned char acid = (currentAcid + 2) % (it->second->getProcesses());
             LteHarqProcessRx* currentProcess = it->second->getProcess(acid);
-            std::vector<RxUnitStatus> procStatus = currentProcess->getProcessStatus();
-            std::vector<RxUnitStatus>::iterator pit = procStatus.begin();
-            for (; pit != procStatus.end(); ++pit )
+            for (Codeword cw = 0; cw < MAX_CODEWORDS; ++cw)
             {
-                if (pit->second == RXHARQ_PDU_CORRUPTED)
+                if (currentProcess->getUnitStatus(cw) == RXHARQ_PDU_CORRUPTED)
                 {
                     skip = false;
                     break;
@@ -204,6 +204,8 @@ LteSchedulerEnbUl::rtxschedule()
             }
             EV << NOW << "LteSchedulerEnbUl::rtxschedule user " << nodeId << " allocated bytes : " << allocatedBytes << endl;
         }
+        for (unsigned int i = 0; i < departed.size(); i++)
+            harqRxBuffers_->erase(departed[i]);
 
         if (mac_->isD2DCapable())
         {
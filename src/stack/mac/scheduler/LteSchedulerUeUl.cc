@@ -73,13 +73,13 @@ LteSchedulerUeUl::schedule()
 
         // invoke the schedule() method of the attached LCP scheduler in order to schedule
         // the connections provided
-        std::map<MacCid, unsigned int>& sdus = lcgScheduler_->schedule(availableBytes, dir);
+        ScheduleList& sdus = lcgScheduler_->schedule(availableBytes, dir);
 
         // TODO check if this jump is ok
         if (sdus.empty())
             continue;
 
-        std::map<MacCid, unsigned int>::const_iterator it = sdus.begin(), et = sdus.end();
+        ScheduleList::const_iterator it = sdus.begin(), et = sdus.end();
         for (; it != et; ++it)
         {
             // set schedule list entry
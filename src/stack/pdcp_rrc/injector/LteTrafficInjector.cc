@@ -0,0 +1,211 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#include <cmath>
+#include "LteTrafficInjector.h"
+#include "LteInjectedPacket_m.h"
+#include "UDPPacket.h"
+
+Define_Module(LteTrafficInjector);
+
+LteTrafficInjector::LteTrafficInjector()
+{
+    pdcp_ = NULL;
+    binder_ = NULL;
+    trace_ = NULL;
+    injectTimer_ = NULL;
+    flowsCreated_ = false;
+}
+
+LteTrafficInjector::~LteTrafficInjector()
+{
+    cancelAndDelete(injectTimer_);
+    if (trace_ != NULL)
+        VoDTraceCache::release(trace_);
+}
+
+void LteTrafficInjector::initialize()
+{
+    pdcp_ = check_and_cast<LtePdcpRrcBase*>(getParentModule()->getSubmodule("pdcpRrc"));
+    binder_ = getBinder();
+
+    voipPacketSize_ = par("voipPacketSize");
+    shapeTalk_ = par("shape_talk");
+    scaleTalk_ = par("scale_talk");
+    shapeSil_ = par("shape_sil");
+    scaleSil_ = par("scale_sil");
+    silences_ = par("silences");
+    samplingTime_ = par("sampling_time");
+
+    frameInterval_ = 1.0 / (int) par("fps");
+    if ((int) par("videoFlowsPerUe") > 0)
+    {
+        std::string fileName = par("vod_trace_file").stringValue();
+        if (fileName.empty())
+            throw cRuntimeError("LteTrafficInjector::initialize - video flows require a vod_trace_file");
+        // the trace is shared with the VoD servers using the same file
+        trace_ = VoDTraceCache::acquire(fileName, false);
+        if (trace_->ns2.empty())
+            throw cRuntimeError("LteTrafficInjector::initialize - empty trace file %s", fileName.c_str());
+    }
+
+    cbrPacketSize_ = par("cbrPacketSize");
+    cbrInterval_ = par("cbrInterval");
+
+    injectTimer_ = new cMessage("injectTimer");
+    scheduleAt(simTime() + par("startTime"), injectTimer_);
+
+    WATCH(flowsCreated_);
+}
+
+void LteTrafficInjector::handleMessage(cMessage *msg)
+{
+    if (msg != injectTimer_)
+        throw cRuntimeError("LteTrafficInjector::handleMessage - unexpected message %s", msg->getName());
+
+    if (!flowsCreated_)
+        createFlows();
+
+    // serve all the flows that are due now
+    while (!calendar_.empty() && calendar_.top().first <= NOW)
+    {
+        unsigned int index = calendar_.top().second;
+        calendar_.pop();
+        calendar_.push(CalendarEntry(generate(flows_[index]), index));
+    }
+
+    if (!calendar_.empty())
+        scheduleAt(calendar_.top().first, injectTimer_);
+}
+
+void LteTrafficInjector::createFlows()
+{
+    flowsCreated_ = true;
+    nodeId_ = getAncestorPar("macNodeId");
+
+    int perUe[3];
+    perUe[INJECTED_VOIP] = par("voipFlowsPerUe");
+    perUe[INJECTED_VIDEO] = par("videoFlowsPerUe");
+    perUe[INJECTED_CBR] = par("cbrFlowsPerUe");
+
+    ConnectedUesMap ues = binder_->getDeployedUes(nodeId_, DL);
+    ConnectedUesMap::const_iterator it = ues.begin();
+    for (; it != ues.end(); ++it)
+    {
+        if (!it->second)
+            continue;
+
+        for (int model = INJECTED_VOIP; model <= INJECTED_CBR; model++)
+        {
+            for (int i = 0; i < perUe[model]; i++)
+            {
+                InjectedFlow flow;
+                flow.id = ((unsigned int) nodeId_ << 16) | flows_.size();
+                flow.model = (InjectedTrafficModel) model;
+                flow.ueId = it->first;
+                flow.lcid = pdcp_->allocateLcid();
+                flow.framesLeft = 0;
+                flow.nextTalkspurt = 0;
+                // video flows do not start all from the same frame
+                flow.frame = (trace_ != NULL) ? intuniform(0, trace_->ns2.size() - 1) : 0;
+                flow.sentPackets = 0;
+                flow.sentBytes = 0;
+                flow.skippedPackets = 0;
+
+                calendar_.push(CalendarEntry(NOW + par("flowStartOffset").doubleValue(), flows_.size()));
+                flows_.push_back(flow);
+            }
+        }
+    }
+
+    EV << "LteTrafficInjector::createFlows - created " << flows_.size() << " flows towards "
+       << ues.size() << " UEs of eNB " << nodeId_ << endl;
+}
+
+simtime_t LteTrafficInjector::generate(InjectedFlow& flow)
+{
+    switch (flow.model)
+    {
+        case INJECTED_VOIP:
+        {
+            if (flow.framesLeft == 0)
+            {
+                // new talkspurt, followed by a silence period
+                simtime_t durTalk = weibull(scaleTalk_, shapeTalk_);
+                simtime_t durSil = silences_ ? weibull(scaleSil_, shapeSil_) : 0;
+                flow.framesLeft = (unsigned int) ceil(durTalk / samplingTime_);
+                // a talkspurt must be at least 1 frame long
+                if (flow.framesLeft == 0)
+                    flow.framesLeft = 1;
+                flow.nextTalkspurt = NOW + durTalk + durSil;
+            }
+            inject(flow, "VoIP", voipPacketSize_);
+            flow.framesLeft--;
+            return (flow.framesLeft > 0) ? NOW + samplingTime_ : flow.nextTalkspurt;
+        }
+        case INJECTED_VIDEO:
+        {
+            const std::vector<VoDNs2Record>& trace = trace_->ns2;
+            inject(flow, "VoDPacket", trace[flow.frame % trace.size()].size);
+            flow.frame++;
+            return NOW + frameInterval_;
+        }
+        case INJECTED_CBR:
+        {
+            inject(flow, "CBR", cbrPacketSize_);
+            return NOW + cbrInterval_;
+        }
+    }
+    throw cRuntimeError("LteTrafficInjector::generate - unknown traffic model %d", flow.model);
+}
+
+void LteTrafficInjector::inject(InjectedFlow& flow, const char* name, int payloadSize)
+{
+    // the flow is sent only while the UE is served by this eNB
+    if (binder_->getNextHop(flow.ueId) != nodeId_)
+    {
+        flow.skippedPackets++;
+        return;
+    }
+
+    LteInjectedPacket* pkt = new LteInjectedPacket(name);
+    pkt->setFlowId(flow.id);
+    pkt->setTimestamp(NOW);
+    // the PDCP sees the same SDU as for a UDP application
+    int headerSize = IP_HEADER_BYTES + UDP_HEADER_BYTES;
+    pkt->setByteLength(payloadSize + headerSize);
+
+    FlowControlInfo* lteInfo = new FlowControlInfo();
+    lteInfo->setSourceId(nodeId_);
+    lteInfo->setDestId(flow.ueId);
+    lteInfo->setLcid(flow.lcid);
+    lteInfo->setHeaderSize(headerSize);
+    lteInfo->setD2dTxPeerId(0);
+    lteInfo->setD2dRxPeerId(0);
+
+    flow.sentPackets++;
+    flow.sentBytes += pkt->getByteLength();
+
+    pdcp_->injectPacket(pkt, lteInfo);
+}
+
+void LteTrafficInjector::finish()
+{
+    // per-flow counters, to be matched with the KPIs recorded by the PDCP of the UEs
+    std::vector<InjectedFlow>::const_iterator it = flows_.begin();
+    for (; it != flows_.end(); ++it)
+    {
+        std::stringstream name;
+        name << "injectedFlow[" << it->id << "]:";
+        recordScalar((name.str() + "ueId").c_str(), it->ueId);
+        recordScalar((name.str() + "txPackets").c_str(), it->sentPackets);
+        recordScalar((name.str() + "txBytes").c_str(), it->sentBytes);
+        recordScalar((name.str() + "skippedPackets").c_str(), it->skippedPackets);
+    }
+}
@@ -0,0 +1,130 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+#ifndef _LTE_LTETRAFFICINJECTOR_H_
+#define _LTE_LTETRAFFICINJECTOR_H_
+
+#include <omnetpp.h>
+#include <queue>
+#include <vector>
+#include "LteCommon.h"
+#include "LtePdcpRrc.h"
+#include "VoDTraceCache.h"
+
+/// Traffic models of the injected flows
+enum InjectedTrafficModel
+{
+    INJECTED_VOIP, INJECTED_VIDEO, INJECTED_CBR
+};
+
+/**
+ * State of a single injected flow
+ */
+struct InjectedFlow
+{
+    /// flow identifier, unique in the network
+    unsigned int id;
+    InjectedTrafficModel model;
+    /// destination UE and logical connection of the flow
+    MacNodeId ueId;
+    LogicalCid lcid;
+
+    /// VoIP: frames left in the current talkspurt, and start of the next one
+    unsigned int framesLeft;
+    simtime_t nextTalkspurt;
+
+    /// Video: next trace record
+    unsigned long frame;
+
+    /// generated packets and bytes, and packets not sent because the UE was not served
+    unsigned long sentPackets;
+    unsigned long sentBytes;
+    unsigned long skippedPackets;
+};
+
+/**
+ * \class LteTrafficInjector
+ * \brief Cell-level generator of downlink flows
+ *
+ * Generates the downlink traffic of many flows towards the UEs served
+ * by the eNB, without instantiating applications, transport and IP
+ * modules for them. Each flow follows one of the models of the
+ * SimuLTE applications:
+ * - VoIP: talkspurt/silence periods as in VoIPSender
+ * - video: frame sizes read from an ns2 trace, as in VoDUDPServer
+ * - CBR: fixed-size packets at a fixed interval
+ *
+ * All the flows share a single calendar, served by one self message:
+ * at each firing the packets of all the due flows are passed directly
+ * to the PDCP of the eNB, which sends them on the logical connection
+ * of the flow. Per-flow KPIs are collected by the PDCP of the
+ * receiving UE.
+ */
+class LteTrafficInjector : public cSimpleModule
+{
+  protected:
+    /// PDCP of this eNB
+    LtePdcpRrcBase* pdcp_;
+    /// Binder reference
+    LteBinder* binder_;
+    /// Id of this eNB
+    MacNodeId nodeId_;
+
+    /// Flows, created when the traffic starts
+    std::vector<InjectedFlow> flows_;
+    bool flowsCreated_;
+
+    /// Merged calendar: next packet time of each flow
+    typedef std::pair<simtime_t, unsigned int> CalendarEntry;
+    std::priority_queue<CalendarEntry, std::vector<CalendarEntry>, std::greater<CalendarEntry> > calendar_;
+    cMessage* injectTimer_;
+
+    /// VoIP model
+    int voipPacketSize_;
+    double shapeTalk_;
+    double scaleTalk_;
+    double shapeSil_;
+    double scaleSil_;
+    bool silences_;
+    simtime_t samplingTime_;
+
+    /// Video model
+    const VoDTrace* trace_;
+    simtime_t frameInterval_;
+
+    /// CBR model
+    int cbrPacketSize_;
+    simtime_t cbrInterval_;
+
+    virtual void initialize();
+    virtual void handleMessage(cMessage *msg);
+    virtual void finish();
+
+    /**
+     * Creates the flows towards the UEs currently served by this eNB
+     */
+    void createFlows();
+
+    /**
+     * Generates the packet of the given flow due now, if any,
+     * and returns the time of the following one
+     */
+    simtime_t generate(InjectedFlow& flow);
+
+    /**
+     * Builds a packet of the given flow and hands it to the PDCP
+     */
+    void inject(InjectedFlow& flow, const char* name, int payloadSize);
+
+  public:
+    LteTrafficInjector();
+    virtual ~LteTrafficInjector();
+};
+
+#endif
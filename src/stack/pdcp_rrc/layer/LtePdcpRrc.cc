@@ -132,8 +132,18 @@ void LtePdcpRrcBase::fromDataPort(cPacket *pkt)
     EV << "LteRrc : Assigned Lcid: " << mylcid << "\n";
     EV << "LteRrc : Assigned Node ID: " << nodeId_ << "\n";
 
+    // NOTE setLcid and setSourceId have been anticipated for using in "ctrlInfoToMacCid" function
+    lteInfo->setLcid(mylcid);
+    lteInfo->setSourceId(nodeId_);
+    lteInfo->setDestId(getDestId(lteInfo));
+
+    sendToRlc(pkt, lteInfo);
+}
+
+void LtePdcpRrcBase::sendToRlc(cPacket *pkt, FlowControlInfo* lteInfo)
+{
     // get the PDCP entity for this LCID
-    LtePdcpEntity* entity = getEntity(mylcid);
+    LtePdcpEntity* entity = getEntity(lteInfo->getLcid());
 
     // get the sequence number for this PDCP SDU.
     // Note that the numbering depends on the entity the packet is associated to.
@@ -141,10 +151,6 @@ void LtePdcpRrcBase::fromDataPort(cPacket *pkt)
 
     // set sequence number
     lteInfo->setSequenceNumber(sno);
-    // NOTE setLcid and setSourceId have been anticipated for using in "ctrlInfoToMacCid" function
-    lteInfo->setLcid(mylcid);
-    lteInfo->setSourceId(nodeId_);
-    lteInfo->setDestId(getDestId(lteInfo));
 
     // PDCP Packet creation
     LtePdcpPdu* pdcpPkt = new LtePdcpPdu("LtePdcpPdu");
@@ -158,7 +164,6 @@ void LtePdcpRrcBase::fromDataPort(cPacket *pkt)
     EV << "LtePdcp : Packet size " << pdcpPkt->getByteLength() << " Bytes\n";
 
     lteInfo->setSourceId(nodeId_);
-    lteInfo->setLcid(mylcid);
     pdcpPkt->setControlInfo(lteInfo);
 
     EV << "LtePdcp : Sending packet " << pdcpPkt->getName() << " on port "
@@ -169,6 +174,22 @@ void LtePdcpRrcBase::fromDataPort(cPacket *pkt)
     emit(sentPacketToLowerLayer, pdcpPkt);
 }
 
+void LtePdcpRrcBase::injectPacket(cPacket* pkt, FlowControlInfo* lteInfo)
+{
+    Enter_Method_Silent("injectPacket");
+    take(pkt);
+
+    emit(receivedPacketFromUpperLayer, pkt);
+
+    setTrafficInformation(pkt, lteInfo);
+    headerCompress(pkt, lteInfo->getHeaderSize()); // header compression
+
+    EV << "LtePdcp : Injected packet " << pkt->getName() << " for node " << lteInfo->getDestId()
+       << " on LCID " << lteInfo->getLcid() << "\n";
+
+    sendToRlc(pkt, lteInfo);
+}
+
 void LtePdcpRrcBase::fromEutranRrcSap(cPacket *pkt)
 {
     // TODO For now use LCID 1000 for Control Traffic coming from RRC
@@ -199,6 +220,16 @@ void LtePdcpRrcBase::toDataPort(cPacket *pkt)
     delete pdcpPkt;
 
     headerDecompress(upPkt, lteInfo->getHeaderSize()); // Decompress packet header
+
+    LteInjectedPacket* injPkt = dynamic_cast<LteInjectedPacket*>(upPkt);
+    if (injPkt != NULL)
+    {
+        // injected flows have no application at the receiver: stop here
+        delete lteInfo;
+        consumeInjectedPacket(injPkt);
+        return;
+    }
+
     handleControlInfo(upPkt, lteInfo);
 
     EV << "LtePdcp : Sending packet " << upPkt->getName()
@@ -208,6 +239,24 @@ void LtePdcpRrcBase::toDataPort(cPacket *pkt)
     emit(sentPacketToUpperLayer, upPkt);
 }
 
+void LtePdcpRrcBase::consumeInjectedPacket(LteInjectedPacket* pkt)
+{
+    simtime_t delay = NOW - pkt->getTimestamp();
+
+    InjectedFlowStats& stats = injectedFlows_[pkt->getFlowId()];
+    stats.packets++;
+    stats.bytes += pkt->getByteLength();
+    stats.delaySum += delay;
+    if (delay > stats.maxDelay)
+        stats.maxDelay = delay;
+
+    EV << "LtePdcp : Received injected packet of flow " << pkt->getFlowId() << ", delay " << delay << "\n";
+
+    emit(injectedFlowDelay_, delay);
+    emit(injectedFlowBytes_, (long)pkt->getByteLength());
+    delete pkt;
+}
+
 void LtePdcpRrcBase::toEutranRrcSap(cPacket *pkt)
 {
     cPacket* upPkt = pkt->decapsulate();
@@ -250,6 +299,8 @@ void LtePdcpRrcBase::initialize()
     receivedPacketFromLowerLayer = registerSignal("receivedPacketFromLowerLayer");
     sentPacketToUpperLayer = registerSignal("sentPacketToUpperLayer");
     sentPacketToLowerLayer = registerSignal("sentPacketToLowerLayer");
+    injectedFlowDelay_ = registerSignal("injectedFlowDelay");
+    injectedFlowBytes_ = registerSignal("injectedFlowBytes");
 
     // TODO WATCH_MAP(gatemap_);
     WATCH(headerCompressedSize_);
@@ -325,5 +376,16 @@ LtePdcpEntity* LtePdcpRrcBase::getEntity(LogicalCid lcid)
 
 void LtePdcpRrcBase::finish()
 {
-    // TODO make-finish
+    // per-flow KPIs of the injected flows received by this node
+    std::map<unsigned int, InjectedFlowStats>::iterator it = injectedFlows_.begin();
+    for (; it != injectedFlows_.end(); ++it)
+    {
+        const InjectedFlowStats& stats = it->second;
+        std::stringstream name;
+        name << "injectedFlow[" << it->first << "]:";
+        recordScalar((name.str() + "rxPackets").c_str(), stats.packets);
+        recordScalar((name.str() + "rxBytes").c_str(), stats.bytes);
+        recordScalar((name.str() + "meanDelay").c_str(), stats.delaySum / stats.packets);
+        recordScalar((name.str() + "maxDelay").c_str(), stats.maxDelay);
+    }
 }
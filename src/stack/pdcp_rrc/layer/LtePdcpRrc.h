@@ -18,6 +18,7 @@
 #include "LteIp.h"
 #include "LteControlInfo.h"
 #include "LtePdcpPdu_m.h"
+#include "LteInjectedPacket_m.h"
 #include "LtePdcpEntity.h"
 
 /**
@@ -161,6 +162,17 @@ class LtePdcpRrcBase : public cSimpleModule
      */
     virtual void fromDataPort(cPacket *pkt);
 
+    /**
+     * sendToRlc() completes the control info of an SDU whose LCID
+     * and destination are already set: it assigns the PDCP sequence
+     * number, encapsulates the SDU in a PDCP PDU and sends it on the
+     * UM or AM SAP
+     *
+     * @param pkt SDU, after header compression
+     * @param lteInfo Control Info
+     */
+    void sendToRlc(cPacket *pkt, FlowControlInfo* lteInfo);
+
     /**
      * handler for eutran port
      *
@@ -187,6 +199,14 @@ class LtePdcpRrcBase : public cSimpleModule
      */
     void toDataPort(cPacket *pkt);
 
+    /**
+     * Accounts a packet of an injected flow that reached its
+     * destination and deletes it
+     *
+     * @param pkt injected packet, decapsulated
+     */
+    void consumeInjectedPacket(LteInjectedPacket* pkt);
+
     /**
      * handler for tm sap
      *
@@ -277,10 +297,57 @@ class LtePdcpRrcBase : public cSimpleModule
     simsignal_t sentPacketToUpperLayer;
     simsignal_t sentPacketToLowerLayer;
 
+    /*
+     * Statistics of the injected flows received by this node
+     */
+
+    struct InjectedFlowStats
+    {
+        unsigned long packets;
+        unsigned long bytes;
+        simtime_t delaySum;
+        simtime_t maxDelay;
+
+        InjectedFlowStats()
+        {
+            packets = 0;
+            bytes = 0;
+            delaySum = 0;
+            maxDelay = 0;
+        }
+    };
+
+    /// Per-flow statistics, indexed by flow id
+    std::map<unsigned int, InjectedFlowStats> injectedFlows_;
+
+    simsignal_t injectedFlowDelay_;
+    simsignal_t injectedFlowBytes_;
+
   public:
 
     void setDrop(MacCid cid, unsigned int layer, double probability);
     void clearDrop(MacCid cid);
+
+    /**
+     * Returns a new LCID, for a flow that does not go through
+     * the connections table (e.g. an injected flow)
+     */
+    LogicalCid allocateLcid()
+    {
+        return lcid_++;
+    }
+
+    /**
+     * injectPacket() receives a packet generated by the traffic
+     * injector of this node, skipping the upper layers.
+     * The control info must carry the destination id, the LCID and
+     * the header size of the flow; traffic information is set here
+     * from the packet name, as for packets coming from the data port
+     *
+     * @param pkt injected packet
+     * @param lteInfo Control Info
+     */
+    void injectPacket(cPacket* pkt, FlowControlInfo* lteInfo);
 };
 
 class LtePdcpRrcUe : public LtePdcpRrcBase
@@ -53,6 +53,13 @@ class LteChannelModel
      * @param lteinfo pointer to the user control info
      */
     virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo)=0;
+    /*
+     * Mark the beginning and the end of a batch of CQI computations performed
+     * in the same TTI for all the UEs of a cell: in between, the model may
+     * reuse the state of the interfering transmitters across the UEs
+     */
+    virtual void beginCqiBatch() {}
+    virtual void endCqiBatch() {}
     /*
      * Compute the error probability of the transmitted packet according to cqi used, txmode, and the received power
      * after that it throws a random number in order to check if this packet will be corrupted or not
@@ -15,6 +15,7 @@
 #include "LteCommon.h"
 #include "ExtCell.h"
 #include "LtePhyUe.h"
+#include "LteProfiler.h"
 
 // attenuation value to be returned if max. distance of a scenario has been violated
 // and tolerating the maximum distance violation is enabled
@@ -329,6 +330,8 @@ LteRealisticChannelModel::LteRealisticChannelModel(ParameterMap& params,
         delayRMS_ = 363e-9;
     //get binder
     binder_ = getBinder();
+    profiler_ = binder_->getProfiler();
+    cqiBatch_ = false;
     //clear jakes fading map structure
     jakesFadingMap_.clear();
 }
@@ -686,6 +689,9 @@ double computeAngolarAttenuation(double angle) {
 }
 std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserControlInfo* lteInfo)
 {
+    // the cell is set once the eNB involved in the transmission is known
+    LteProfilerScope prof(profiler_, 0, PROF_SINR);
+
     AttenuationVector::iterator it;
     //get tx power
     double recvPower = lteInfo->getTxPower(); // dBm
@@ -791,6 +797,7 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
                        << (( getDeployer(eNbId)->getEnbType() == MACRO_ENB )? "MACRO" : "MICRO") << " - txPwr " << lteInfo->getTxPower()
                        << " - ueCoord[" << ueCoord << "] - enbCoord[" << enbCoord << "] - ueId[" << ueId << "] - enbId[" << eNbId << "]" <<
                        endl;
+    prof.setCell(eNbId);
     //=================== END PARAMETERS SETUP =======================
 
     //=============== PATH LOSS + SHADOWING + FADING =================
@@ -967,6 +974,20 @@ std::vector<double> LteRealisticChannelModel::getSINR(LteAirFrame *frame, UserCo
     return snrVector;
 }
 
+void LteRealisticChannelModel::beginCqiBatch()
+{
+    cqiBatch_ = true;
+    batchEnbBands_.clear();
+    batchExtCellBands_.clear();
+}
+
+void LteRealisticChannelModel::endCqiBatch()
+{
+    cqiBatch_ = false;
+    batchEnbBands_.clear();
+    batchExtCellBands_.clear();
+}
+
 std::vector<double> LteRealisticChannelModel::getRSRP_D2D(LteAirFrame *frame, UserControlInfo* lteInfo_1, MacNodeId destId, Coord destCoord)
 {
     AttenuationVector::iterator it;
@@ -1493,83 +1514,105 @@ double LteRealisticChannelModel::jakesFading(MacNodeId nodeId, double speed,
      *
      * thus the actual map should be choosen carefully (i.e. just check the cqiDL flag)
      */
-    JakesFadingMap * actualJakesMap;
+    LteRealisticChannelModel * owner;
 
     if (cqiDl) // if we are computing a DL CQI we need the Jakes Map stored on the UE side
-        actualJakesMap = obtainUeJakesMap(nodeId);
+        owner = obtainUeChannelModel(nodeId);
 
     else
-        actualJakesMap = &jakesFadingMap_;
+        owner = this;
+
+    return owner->getJakesFading(nodeId, speed)[band];
+}
+
+const std::vector<double>& LteRealisticChannelModel::getJakesFading(MacNodeId nodeId, double speed)
+{
+    JakesFadingMap::iterator it = jakesFadingMap_.find(nodeId);
 
     //if this is the first time that we compute fading for current user
-    if (actualJakesMap->find(nodeId) == actualJakesMap->end())
+    if (it == jakesFadingMap_.end())
     {
-        //clear the map
-        // FIXME: possible memory leak
-        (*actualJakesMap)[nodeId].clear();
+        JakesFadingState& state = jakesFadingMap_[nodeId];
+        state.angleOfArrival.reserve(band_ * fadingPaths_);
+        state.delayPhase.reserve(band_ * fadingPaths_);
+
+        // convert carrier frequency from GHz to Hz
+        double f = carrierFrequency_ * 1000000000;
 
         //for each band we are going to create a jakes fading
         for (unsigned int j = 0; j < band_; j++)
         {
-            //clear some structure
-            JakesFadingData temp;
-            temp.angleOfArrival.clear();
-            temp.delaySpread.clear();
-
             //for each fading path
             for (int i = 0; i < fadingPaths_; i++)
             {
                 //get angle of arrivals
-                temp.angleOfArrival.push_back(cos(uniform(getEnvir()->getRNG(0),0, M_PI)));
+                state.angleOfArrival.push_back(cos(uniform(getEnvir()->getRNG(0),0, M_PI)));
 
                 //get delay spread
-                temp.delaySpread.push_back(exponential(getEnvir()->getRNG(0),delayRMS_));
+                simtime_t delaySpread = exponential(getEnvir()->getRNG(0),delayRMS_);
+                state.delayPhase.push_back(delaySpread.dbl() * f);
             }
-            //store the jakes fadint for this user
-            (*actualJakesMap)[nodeId].push_back(temp);
         }
+        state.gainTime = -1;
+        state.gainSpeed = 0;
+        state.gain.resize(band_);
+        it = jakesFadingMap_.find(nodeId);
     }
+
+    JakesFadingState& state = it->second;
+
+    // the fading only depends on time and speed: all the calls
+    // for the same values (DL data, feedback, D2D...) share the result
+    if (state.gainTime == simTime() && state.gainSpeed == speed)
+        return state.gain;
+
     // convert carrier frequency from GHz to Hz
     double f = carrierFrequency_ * 1000000000;
 
     //get transmission time start (TTI =1ms)
     simtime_t t = simTime().dbl() - 0.001;
 
-    double re_h = 0;
-    double im_h = 0;
-
     // Compute Doppler shift.
     double doppler_shift = (speed * f) / SPEED_OF_LIGHT;
 
-    for (int i = 0; i < fadingPaths_; i++)
+    // One ring model/Clarke's model plus f-selectivity according to Cavers:
+    // Due to isotropic antenna gain pattern on all paths only a^2 can be received on all paths.
+    // Since we are interested in attenuation a:=1, attenuation per path is then:
+    double attenuation = (1.00 / sqrt(static_cast<double>(fadingPaths_)));
+
+    const double* angleOfArrival = &state.angleOfArrival[0];
+    const double* delayPhase = &state.delayPhase[0];
+    for (unsigned int j = 0; j < band_; j++)
     {
-        // Phase shift due to Doppler => t-selectivity.
-        double phi_d = actualJakesMap->at(nodeId).at(band).angleOfArrival[i] * doppler_shift;
+        double re_h = 0;
+        double im_h = 0;
 
-        // Phase shift due to delay spread => f-selectivity.
-        double phi_i = actualJakesMap->at(nodeId).at(band).delaySpread[i].dbl() * f;
+        for (int i = 0; i < fadingPaths_; i++)
+        {
+            // Phase shift due to Doppler => t-selectivity.
+            double phi_d = angleOfArrival[i] * doppler_shift;
 
-        // Calculate resulting phase due to t-selective and f-selective fading.
-        double phi = 2.00 * M_PI * (phi_d * t.dbl() - phi_i);
+            // Phase shift due to delay spread => f-selectivity.
+            double phi_i = delayPhase[i];
 
-        // One ring model/Clarke's model plus f-selectivity according to Cavers:
-        // Due to isotropic antenna gain pattern on all paths only a^2 can be received on all paths.
-        // Since we are interested in attenuation a:=1, attenuation per path is then:
-        double attenuation = (1.00 / sqrt(static_cast<double>(fadingPaths_)));
+            // Calculate resulting phase due to t-selective and f-selective fading.
+            double phi = 2.00 * M_PI * (phi_d * t.dbl() - phi_i);
 
-        // Convert to cartesian form and aggregate {Re, Im} over all fading paths.
-        re_h = re_h + attenuation * cos(phi);
-        im_h = im_h - attenuation * sin(phi);
+            // Convert to cartesian form and aggregate {Re, Im} over all fading paths.
+            re_h = re_h + attenuation * cos(phi);
+            im_h = im_h - attenuation * sin(phi);
+        }
+        angleOfArrival += fadingPaths_;
+        delayPhase += fadingPaths_;
 
-        //        EV << "ID=" << nodeId << " - t[" << t << "] - dopplerShift[" << doppler_shift << "] - phiD[" <<
-        //                phi_d << "] - phiI[" << phi_i << "] - phi[" << phi << "] - attenuation[" << attenuation << "] - f["
-        //                << f << "] - Band[" << band << "] - cos(phi)["
-        //                << cos(phi) << "]" << endl;
+        // Output: |H_f|^2 = absolute channel impulse response due to fading.
+        // Note that this may be >1 due to constructive interference.
+        state.gain[j] = linearToDb(re_h * re_h + im_h * im_h);
     }
+    state.gainTime = simTime();
+    state.gainSpeed = speed;
 
-    // Output: |H_f|^2 = absolute channel impulse response due to fading.
-    // Note that this may be >1 due to constructive interference.
-    return linearToDb(re_h * re_h + im_h * im_h);
+    return state.gain;
 }
 
 bool LteRealisticChannelModel::error(LteAirFrame *frame,
@@ -2150,6 +2193,17 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
     att, // dBm
     angolarAtt; // dBm
 
+    // within a CQI batch, the band status of the ext cells is read once
+    bool useBatch = cqiBatch_ && isCqi;
+    if (useBatch && batchExtCellBands_.size() != list.size())
+    {
+        batchExtCellBands_.assign(list.size(), std::vector<bool>(band_, false));
+        for (unsigned int j = 0; j < list.size(); j++)
+            for (unsigned int i = 0; i < band_; i++)
+                batchExtCellBands_[j][i] = (list[j]->getBandStatus(i) != 0);
+    }
+    unsigned int cellIndex = 0;
+
     //compute distance for each cell
     while (it != list.end())
     {
@@ -2194,7 +2248,11 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
         // add interference in those bands where the ext cell is active
         for (unsigned int i = 0; i < band_; i++) {
             int occ;
-            if (isCqi)  // check slot occupation for this TTI
+            if (useBatch)
+            {
+                occ = batchExtCellBands_[cellIndex][i];
+            }
+            else if (isCqi)  // check slot occupation for this TTI
             {
                 occ = (*it)->getBandStatus(i);
             }
@@ -2211,6 +2269,7 @@ bool LteRealisticChannelModel::computeExtCellInterference(MacNodeId eNbId, MacNo
         }
 
         it++;
+        cellIndex++;
     }
 
     return true;
@@ -2296,17 +2355,14 @@ double LteRealisticChannelModel::computeExtCellPathLoss(double dist, MacNodeId n
     return attenuation;
 }
 
-LteRealisticChannelModel::JakesFadingMap * LteRealisticChannelModel::obtainUeJakesMap(MacNodeId id)
+LteRealisticChannelModel * LteRealisticChannelModel::obtainUeChannelModel(MacNodeId id)
 {
     // obtain a reference to UE phy
     LtePhyBase * ltePhy = check_and_cast<LtePhyBase*>(
             getSimulation()->getModule(binder_->getOmnetId(id))->getSubmodule("nic")->getSubmodule("phy"));
 
-    // get the associated channel and get a reference to its Jakes Map
-    LteRealisticChannelModel * re = dynamic_cast<LteRealisticChannelModel *>(ltePhy->getChannelModel());
-    JakesFadingMap * j = re->getJakesMap();
-
-    return j;
+    // get the associated channel, holding the Jakes Map of the UE side
+    return check_and_cast<LteRealisticChannelModel *>(ltePhy->getChannelModel());
 }
 
 bool LteRealisticChannelModel::computeMultiCellInterference(MacNodeId eNbId, MacNodeId ueId, Coord coord, bool isCqi,
@@ -2385,7 +2441,23 @@ bool LteRealisticChannelModel::computeMultiCellInterference(MacNodeId eNbId, Mac
 
         txPwr = (*it)->txPwr - angolarAtt - cableLoss_ + antennaGainEnB_ + antennaGainUe_;
 
-        if(isCqi)// check slot occupation for this TTI
+        if (cqiBatch_ && isCqi) // band occupation read once per CQI batch
+        {
+            std::map<MacNodeId, std::vector<bool> >::iterator bt = batchEnbBands_.find(id);
+            if (bt == batchEnbBands_.end())
+            {
+                std::vector<bool> bands(band_, false);
+                for (unsigned int i = 0; i < band_; i++)
+                    bands[i] = ((*it)->mac->getBandStatus(i) != 0);
+                bt = batchEnbBands_.insert(std::make_pair(id, bands)).first;
+            }
+            for (unsigned int i = 0; i < band_; i++)
+            {
+                if (bt->second[i])
+                    (*interference)[i] += dBmToLinear(txPwr-att);//(dBm-dB)=dBm
+            }
+        }
+        else if(isCqi)// check slot occupation for this TTI
         {
             for(unsigned int i=0;i<band_;i++)
             {
@@ -13,6 +13,7 @@
 #include "LteChannelModel.h"
 
 class LteBinder;
+class LteProfiler;
 
 /*
  * Realistic Channel Model as taken from
@@ -92,6 +93,15 @@ class LteRealisticChannelModel : public LteChannelModel
     //pointer to Binder module
     LteBinder* binder_;
 
+    //per-TTI stages profiler (NULL if profiling is disabled)
+    LteProfiler* profiler_;
+
+    // true between beginCqiBatch() and endCqiBatch()
+    bool cqiBatch_;
+    // band occupation of the interfering eNBs and ext cells, read once per CQI batch
+    std::map<MacNodeId, std::vector<bool> > batchEnbBands_;
+    std::vector<std::vector<bool> > batchExtCellBands_;
+
     //Cable loss
     double cableLoss_;
 
@@ -112,20 +122,23 @@ class LteRealisticChannelModel : public LteChannelModel
 
     bool tolerateMaxDistViolation_;
 
-    //Struct used to store information about jakes fading
-    struct JakesFadingData
+    //Struct used to store information about jakes fading of a link
+    struct JakesFadingState
     {
+        // per-band, per-path parameters, stored band by band
+        // (the entry of path i on band j is at j * fadingPaths_ + i)
         std::vector<double> angleOfArrival;
-        std::vector<simtime_t> delaySpread;
-    };
+        std::vector<double> delayPhase;    // delay spread times the carrier frequency
 
-    // for each node and for each band we store information about jakes fading
-    std::map<MacNodeId, std::vector<JakesFadingData> > jakesFadingMap_;
-
-    typedef std::vector<JakesFadingData> JakesFadingVector;
-    typedef std::map<MacNodeId, JakesFadingVector> JakesFadingMap;
+        // fading of all the bands (dB), valid for the given time and speed
+        simtime_t gainTime;
+        double gainSpeed;
+        std::vector<double> gain;
+    };
 
-//    typedef std::map<MacNodeId,std::vector<JakesFadingData> > JakesFadingMap;
+    // for each node we store information about jakes fading
+    typedef std::map<MacNodeId, JakesFadingState> JakesFadingMap;
+    JakesFadingMap jakesFadingMap_;
 
     enum FadingType
     {
@@ -174,6 +187,13 @@ class LteRealisticChannelModel : public LteChannelModel
      * @param lteinfo pointer to the user control info
      */
     virtual std::vector<double> getSINR(LteAirFrame *frame, UserControlInfo* lteInfo);
+    /*
+     * Begin/end a batch of CQI computations for the UEs of this cell.
+     * Within a batch, the band occupation of the interfering cells is
+     * read once and shared by all the UEs
+     */
+    virtual void beginCqiBatch();
+    virtual void endCqiBatch();
     /*
      * Compute Received useful signal for D2D transmissions
      */
@@ -272,6 +292,15 @@ class LteRealisticChannelModel : public LteChannelModel
      * @param cqiDl if true, the jakesMap in the UE side should be used
      */
     double jakesFading(MacNodeId noedId, double speed, unsigned int band, bool cqiDl);
+    /*
+     * Returns the Jakes fading of all the bands for the given node, as seen
+     * by this channel model. The values are computed once for a given time
+     * and speed and shared by all the following calls
+     *
+     * @param nodeid mac node id of UE
+     * @param speed speed of UE
+     */
+    const std::vector<double>& getJakesFading(MacNodeId nodeId, double speed);
     /*
      * Compute LOS probability
      *
@@ -326,10 +355,10 @@ class LteRealisticChannelModel : public LteChannelModel
     double computeExtCellPathLoss(double dist, MacNodeId nodeId);
 
     /*
-     * Obtain the jakes map for the specified UE
+     * Obtain the channel model of the specified UE (holding its jakes map)
      * @param id mac id of the user
      */
-    JakesFadingMap * obtainUeJakesMap(MacNodeId id);
+    LteRealisticChannelModel * obtainUeChannelModel(MacNodeId id);
 };
 
 #endif
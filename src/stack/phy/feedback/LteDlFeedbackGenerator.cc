@@ -9,6 +9,8 @@
 
 #include "LteDlFeedbackGenerator.h"
 #include "LtePhyUe.h"
+#include "LtePhyEnb.h"
+#include "LteProfiler.h"
 
 Define_Module(LteDlFeedbackGenerator);
 
@@ -18,6 +20,8 @@ Define_Module(LteDlFeedbackGenerator);
 
 void LteDlFeedbackGenerator::createFeedback(FbPeriodicity per)
 {
+    LteProfilerScope prof(profiler_, masterId_, PROF_FEEDBACK);
+
     EV << NOW << " LteDlFeedbackGenerator::createFeedback " << periodicityToA(per) << endl;
 
     LteFeedbackDoubleVector *fb;
@@ -108,6 +112,7 @@ void LteDlFeedbackGenerator::initialize(int stage)
         rbAllocationType_ = getRbAllocationType(
             par("rbAllocationType").stringValue());
         usePeriodic_ = par("usePeriodic");
+        batchedFeedback_ = par("batchedFeedback");
         currentTxMode_ = aToTxMode(par("initialTxMode"));
 
         generatorType_ = getFeedbackGeneratorType(
@@ -115,6 +120,7 @@ void LteDlFeedbackGenerator::initialize(int stage)
 
         masterId_ = getAncestorPar("masterId");
         nodeId_ = getAncestorPar("macNodeId");
+        profiler_ = getBinder()->getProfiler();
 
         /** Initialize timers **/
 
@@ -132,6 +138,7 @@ void LteDlFeedbackGenerator::initialize(int stage)
         WATCH(fbPeriod_);
         WATCH(fbDelay_);
         WATCH(usePeriodic_);
+        WATCH(batchedFeedback_);
         WATCH(currentTxMode_);
     }
     else if (stage == 1)
@@ -159,7 +166,15 @@ void LteDlFeedbackGenerator::initialize(int stage)
            << " feedback computation initialize" << endl;
         WATCH(numBands_);
         WATCH(numPreferredBands_);
-        if (usePeriodic_)
+        if (batchedFeedback_)
+        {
+            // the eNB computes the feedback of all its UEs in one pass:
+            // no sensing and no feedback transmission from this UE
+            if (!feedbackComputationPisa_)
+                throw cRuntimeError("LteDlFeedbackGenerator::initialize - batchedFeedback requires the REAL feedback computation");
+            checkBatchedFeedback();
+        }
+        else if (usePeriodic_)
         {
             tPeriodicSensing_->start(0);
         }
@@ -257,6 +272,11 @@ void LteDlFeedbackGenerator::aperiodicRequest()
 {
     Enter_Method("aperiodicRequest()");
     EV << NOW << " Aperiodic request" << endl;
+    if (batchedFeedback_)
+    {
+        EV << NOW << " Batched feedback: aperiodic request ignored" << endl;
+        return;
+    }
     sensing(APERIODIC);
 }
 
@@ -272,6 +292,14 @@ void LteDlFeedbackGenerator::sendFeedback(LteFeedbackDoubleVector fb,
     EV << "sendFeedback() in DL" << endl;
     EV << "Periodicity: " << periodicityToA(per) << " nodeId: " << nodeId_ << endl;
 
+    FeedbackRequest feedbackReq = getFeedbackRequest();
+    //use PHY function to send feedback
+    (dynamic_cast<LtePhyUe*>(getParentModule()->getSubmodule("phy")))->sendFeedback(
+        fb, fb, feedbackReq);
+}
+
+FeedbackRequest LteDlFeedbackGenerator::getFeedbackRequest()
+{
     FeedbackRequest feedbackReq;
     if (feedbackComputationPisa_)
     {
@@ -286,9 +314,7 @@ void LteDlFeedbackGenerator::sendFeedback(LteFeedbackDoubleVector fb,
     {
         feedbackReq.request = false;
     }
-    //use PHY function to send feedback
-    (dynamic_cast<LtePhyUe*>(getParentModule()->getSubmodule("phy")))->sendFeedback(
-        fb, fb, feedbackReq);
+    return feedbackReq;
 }
 
 // TODO adjust default value
@@ -403,10 +429,23 @@ void LteDlFeedbackGenerator::initializeFeedbackComputation(
     EV << "Feedback Computation \"" << name << "\" loaded." << endl;
 }
 
+void LteDlFeedbackGenerator::checkBatchedFeedback()
+{
+    if (!batchedFeedback_)
+        return;
+
+    LtePhyEnb* enbPhy = dynamic_cast<LtePhyEnb*>(getSimulation()->getModule(
+        getBinder()->getOmnetId(masterId_))->getSubmodule("nic")->getSubmodule("phy"));
+    if (enbPhy == NULL || !enbPhy->isBatchedFeedback())
+        throw cRuntimeError("LteDlFeedbackGenerator - UE %d uses batchedFeedback but its serving eNB %d does not: "
+            "no feedback would be computed for it", nodeId_, masterId_);
+}
+
 void LteDlFeedbackGenerator::handleHandover(MacCellId newEnbId)
 {
     masterId_ = newEnbId;
     deployer_ = getDeployer(masterId_);
+    checkBatchedFeedback();
 
     EV << NOW << " LteDlFeedbackGenerator::handleHandover - Master ID updated to " << masterId_ << endl;
 }
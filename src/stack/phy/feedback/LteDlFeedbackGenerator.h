@@ -21,6 +21,7 @@
 #include "LteFeedbackComputationDummy.h"
 
 class DasFilter;
+class LteProfiler;
 /**
  * @class LteDlFeedbackGenerator
  * @brief Lte Downlink Feedback Generator
@@ -49,6 +50,7 @@ class LteDlFeedbackGenerator : public cSimpleModule
     simtime_t fbDelay_;     /// time interval between sensing and transmission in TTI
 
     bool usePeriodic_;      /// true if we want to use also periodic feedback
+    bool batchedFeedback_;  /// true if the eNB computes the feedback in a cell-wide pass (no timers here)
     TxMode currentTxMode_;  /// transmission mode to use in feedback generation
 
     DasFilter *dasFilter_;  /// reference to das filter
@@ -73,6 +75,9 @@ class LteDlFeedbackGenerator : public cSimpleModule
     MacNodeId masterId_;
     MacNodeId nodeId_;
 
+    // Per-stage TTI profiler (NULL when profiling is disabled)
+    LteProfiler* profiler_;
+
     bool feedbackComputationPisa_;
     private:
 
@@ -92,6 +97,12 @@ class LteDlFeedbackGenerator : public cSimpleModule
 
     void initializeFeedbackComputation(cXMLElement* xmlConfig);
 
+    /**
+     * Checks that the serving eNB computes the feedback of this UE
+     * when batchedFeedback is set, since the UE does not send it
+     */
+    void checkBatchedFeedback();
+
   protected:
 
     /**
@@ -137,6 +148,22 @@ class LteDlFeedbackGenerator : public cSimpleModule
      */
     void setTxMode(TxMode newTxMode);
 
+    /**
+     * Returns true if the feedback of this UE is computed by the
+     * eNB in its cell-wide feedback pass instead of being sensed
+     * and sent by this generator
+     */
+    bool isBatchedFeedback() const
+    {
+        return batchedFeedback_;
+    }
+
+    /**
+     * Returns the request describing the feedback to be
+     * computed by the eNB for this UE
+     */
+    FeedbackRequest getFeedbackRequest();
+
     /*
      * Perform handover-related operations
      * Update cell id and the reference to the deployer
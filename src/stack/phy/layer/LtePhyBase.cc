@@ -30,6 +30,7 @@ void LtePhyBase::initialize(int stage)
     if (stage == inet::INITSTAGE_LOCAL)
     {
         binder_ = getBinder();
+        profiler_ = binder_->getProfiler();
         // get gate ids
         upperGateIn_ = findGate("upperGateIn");
         upperGateOut_ = findGate("upperGateOut");
@@ -74,6 +75,10 @@ void LtePhyBase::handleMessage(cMessage* msg)
 {
     EV << " LtePhyBase::handleMessage - new message received" << endl;
 
+    // the channel model refers to radioPos: bring it up to date before any computation
+    if (lazyPosition)
+        refreshPosition();
+
     if (msg->isSelfMessage())
     {
         handleSelfMessage(msg);
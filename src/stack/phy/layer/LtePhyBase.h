@@ -27,6 +27,8 @@
 #include "LteRealisticChannelModel.h"
 #include "LteDummyChannelModel.h"
 
+class LteProfiler;
+
 /**
  * @class LtePhy
  * @brief Physical layer of Lte Nic.
@@ -89,6 +91,9 @@ class LtePhyBase : public ChannelAccess
     /// Reference to LteBinder
     LteBinder *binder_;
 
+    /// Per-stage TTI profiler (NULL when profiling is disabled)
+    LteProfiler* profiler_;
+
     /// Reference to LteDeployer
     LteDeployer* deployer_;
     //Ue  Tx Power
@@ -11,6 +11,9 @@
 #include "LteFeedbackPkt.h"
 #include "DasFilter.h"
 #include "LteCommon.h"
+#include "LteProfiler.h"
+#include "LteDlFeedbackGenerator.h"
+#include "LteMacEnb.h"
 
 Define_Module(LtePhyEnb);
 
@@ -18,11 +21,18 @@ LtePhyEnb::LtePhyEnb()
 {
     das_ = NULL;
     bdcStarter_ = NULL;
+    batchFbTimer_ = NULL;
+    batchFbDelivery_ = NULL;
+    mac_ = NULL;
 }
 
 LtePhyEnb::~LtePhyEnb()
 {
     cancelAndDelete(bdcStarter_);
+    cancelAndDelete(batchFbTimer_);
+    cancelAndDelete(batchFbDelivery_);
+    for (unsigned int i = 0; i < batchFbPending_.size(); i++)
+        delete batchFbPending_[i];
     if(lteFeedbackComputation_){
         delete lteFeedbackComputation_;
         lteFeedbackComputation_ = NULL;
@@ -49,6 +59,12 @@ void LtePhyEnb::initialize(int stage)
         das_ = new DasFilter(this, binder_, deployer_->getRemoteAntennaSet(),
             0);
 
+        batchedFeedback_ = par("batchedFeedback");
+        batchFbPeriod_ = (simtime_t)(int(par("fbPeriod")) * TTI);// TTI -> seconds
+        batchFbDelay_ = (simtime_t)(int(par("fbDelay")) * TTI);// TTI -> seconds
+        if (batchedFeedback_ && batchFbPeriod_ <= batchFbDelay_)
+            throw cRuntimeError("LtePhyEnb::initialize - Feedback Period MUST be greater than Feedback Delay");
+
         WATCH(nodeType_);
         WATCH(das_);
     }
@@ -82,12 +98,33 @@ void LtePhyEnb::initialize(int stage)
             bdcStarter_ = new cMessage("bdcStarter");
             scheduleAt(NOW, bdcStarter_);
         }
+
+        if (batchedFeedback_)
+        {
+            if (lteFeedbackComputation_ == NULL)
+                throw cRuntimeError("LtePhyEnb::initialize - batchedFeedback requires the REAL feedback computation");
+            mac_ = check_and_cast<LteMacEnb*>(getParentModule()->getSubmodule("mac"));
+
+            // the first pass is aligned with the periodic sensing of the UEs
+            batchFbTimer_ = new cMessage("batchFbTimer");
+            batchFbDelivery_ = new cMessage("batchFbDelivery");
+            scheduleAt(NOW, batchFbTimer_);
+        }
     }
 }
 
 void LtePhyEnb::handleSelfMessage(cMessage *msg)
 {
-    if (msg->isName("bdcStarter"))
+    if (msg == batchFbTimer_)
+    {
+        computeBatchedFeedback();
+        scheduleAt(NOW + batchFbPeriod_, msg);
+    }
+    else if (msg == batchFbDelivery_)
+    {
+        deliverBatchedFeedback();
+    }
+    else if (msg->isName("bdcStarter"))
     {
         // send broadcast message
         LteAirFrame *f = createHandoverMessage();
@@ -326,6 +363,69 @@ void LtePhyEnb::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
        << fbGeneratorTypeToA(req.genType) << " Fb size: " << fb_.size() << endl;
 }
 
+void LtePhyEnb::computeBatchedFeedback()
+{
+    LteProfilerScope prof(profiler_, nodeId_, PROF_FEEDBACK);
+
+    EV << NOW << " LtePhyEnb::computeBatchedFeedback - eNB " << nodeId_ << endl;
+
+    ConnectedUesMap ues = binder_->getDeployedUes(nodeId_, DL);
+
+    // the state of the interfering cells is shared by all the UEs of the pass
+    channelModel_->beginCqiBatch();
+    ConnectedUesMap::const_iterator it = ues.begin();
+    for (; it != ues.end(); ++it)
+    {
+        MacNodeId ueId = it->first;
+        if (!it->second || binder_->getNextHop(ueId) != nodeId_)
+            continue;
+        int omnetId = binder_->getOmnetId(ueId);
+        if (omnetId == 0)
+            continue;
+
+        cModule* nic = getSimulation()->getModule(omnetId)->getSubmodule("nic");
+        LteDlFeedbackGenerator* fbGen = dynamic_cast<LteDlFeedbackGenerator*>(nic->getSubmodule("dlFbGen"));
+        if (fbGen == NULL || !fbGen->isBatchedFeedback())
+            continue;
+        LtePhyBase* uePhy = check_and_cast<LtePhyBase*>(nic->getSubmodule("phy"));
+
+        // same control info as the one attached by LtePhyUe::sendFeedback()
+        UserControlInfo uinfo;
+        uinfo.setSourceId(ueId);
+        uinfo.setDestId(nodeId_);
+        uinfo.setFrameType(FEEDBACKPKT);
+        uinfo.setDirection(UL);
+        uinfo.setTxPower(uePhy->getTxPwr());
+        uinfo.setCoord(uePhy->getCoord());
+        uinfo.feedbackReq = fbGen->getFeedbackRequest();
+
+        LteFeedbackPkt* pkt = new LteFeedbackPkt();
+        pkt->setSourceNodeId(ueId);
+        requestFeedback(&uinfo, NULL, pkt);
+        batchFbPending_.push_back(pkt);
+    }
+    channelModel_->endCqiBatch();
+
+    EV << NOW << " LtePhyEnb::computeBatchedFeedback - computed feedback for " << batchFbPending_.size() << " UEs" << endl;
+
+    if (!batchFbPending_.empty())
+        scheduleAt(NOW + batchFbDelay_, batchFbDelivery_);
+}
+
+void LtePhyEnb::deliverBatchedFeedback()
+{
+    for (unsigned int i = 0; i < batchFbPending_.size(); i++)
+    {
+        LteFeedbackPkt* pkt = batchFbPending_[i];
+        // the UE may have left the cell during the feedback delay
+        if (binder_->getNextHop(pkt->getSourceNodeId()) == nodeId_)
+            mac_->deliverFeedback(pkt);
+        else
+            delete pkt;
+    }
+    batchFbPending_.clear();
+}
+
 void LtePhyEnb::handleFeedbackPkt(UserControlInfo* lteinfo,
     LteAirFrame *frame)
 {
@@ -336,7 +436,10 @@ void LtePhyEnb::handleFeedbackPkt(UserControlInfo* lteinfo,
     // if feedback was generated by dummy phy we can send up to mac else nodeb should generate the "real" feddback
     if (lteinfo->feedbackReq.request)
     {
-        requestFeedback(lteinfo, frame, pkt);
+        {
+            LteProfilerScope prof(profiler_, nodeId_, PROF_FEEDBACK);
+            requestFeedback(lteinfo, frame, pkt);
+        }
         //DEBUG
         LteFeedbackDoubleVector::iterator it;
         LteFeedbackVector::iterator jt;
@@ -14,6 +14,7 @@
 
 class DasFilter;
 class LteFeedbackPkt;
+class LteMacEnb;
 
 class LtePhyEnb : public LtePhyBase
 {
@@ -35,6 +36,20 @@ class LtePhyEnb : public LtePhyBase
     //Used for PisaPhy feedback generator
     LteFeedbackDoubleVector fb_;
 
+    /*
+     * Cell-wide feedback computation (batchedFeedback)
+     */
+    bool batchedFeedback_;
+    simtime_t batchFbPeriod_;
+    simtime_t batchFbDelay_;
+    /// self messages triggering the feedback pass and the delivery of its results
+    cMessage* batchFbTimer_;
+    cMessage* batchFbDelivery_;
+    /// feedback computed by the last pass, waiting for the feedback delay
+    std::vector<LteFeedbackPkt*> batchFbPending_;
+    /// MAC of this eNB, receiving the batched feedback
+    LteMacEnb* mac_;
+
     virtual void initialize(int stage);
 
     virtual void handleSelfMessage(cMessage *msg);
@@ -42,6 +57,19 @@ class LtePhyEnb : public LtePhyBase
     bool handleControlPkt(UserControlInfo* lteinfo, LteAirFrame* frame);
     void handleFeedbackPkt(UserControlInfo* lteinfo, LteAirFrame* frame);
     virtual void requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame, LteFeedbackPkt* pkt);
+
+    /**
+     * Computes in a single pass the feedback of all the attached UEs
+     * using batched feedback, as requestFeedback() would do on the
+     * reception of their feedback packets. The results are delivered
+     * to the MAC after the feedback delay
+     */
+    void computeBatchedFeedback();
+
+    /**
+     * Hands the feedback computed by the last pass to the MAC
+     */
+    void deliverBatchedFeedback();
     /**
      * Getter for the Das Filter
      */
@@ -54,6 +82,15 @@ class LtePhyEnb : public LtePhyBase
     LtePhyEnb();
     virtual ~LtePhyEnb();
 
+    /**
+     * Returns true if this eNB computes the feedback of its UEs
+     * in a cell-wide pass (see LteDlFeedbackGenerator)
+     */
+    bool isBatchedFeedback() const
+    {
+        return batchedFeedback_;
+    }
+
 //        void setMicroTxPower();
 };
 
@@ -104,28 +104,34 @@ void LtePhyEnbD2D::requestFeedback(UserControlInfo* lteinfo, LteAirFrame* frame,
 
             if (enableD2DCqiReporting_)
             {
-                // compute D2D feedback for all possible peering UEs
-                std::vector<UeInfo*>* ueList = binder_->getUeList();
-                std::vector<UeInfo*>::iterator it = ueList->begin();
-                for (; it != ueList->end(); ++it)
+                // compute D2D feedback for all the UEs peering with the source UE
+                // (only the peers served by this cell are considered)
+                MacNodeId srcId = lteinfo->getSourceId();
+                const std::set<MacNodeId>* peers = binder_->getD2DPeers(srcId);
+                if (peers != NULL)
                 {
-                    MacNodeId peerId = (*it)->id;
-                    if (peerId != lteinfo->getSourceId() && binder_->checkD2DCapability(lteinfo->getSourceId(), peerId) && binder_->getNextHop(peerId) == nodeId_)
+                    std::set<MacNodeId>::const_iterator it = peers->begin();
+                    for (; it != peers->end(); ++it)
                     {
-                         // the source UE might communicate with this peer using D2D, so compute feedback
+                        MacNodeId peerId = *it;
+                        UeInfo* peerInfo = binder_->getUeInfo(peerId);
+                        if (peerId != srcId && peerInfo != NULL && binder_->getNextHop(peerId) == nodeId_)
+                        {
+                             // the source UE might communicate with this peer using D2D, so compute feedback
 
-                         // retrieve the position of the peer
-                         Coord peerCoord = (*it)->phy->getCoord();
+                             // retrieve the position of the peer
+                             Coord peerCoord = peerInfo->phy->getCoord();
 
-                         // get SINR for this link
-                         snr = channelModel_->getSINR_D2D(frame, lteinfo, peerId, peerCoord, nodeId_);
+                             // get SINR for this link
+                             snr = channelModel_->getSINR_D2D(frame, lteinfo, peerId, peerCoord, nodeId_);
 
-                         // compute the feedback for this link
-                         fb_ = lteFeedbackComputation_->computeFeedback(type, rbtype, txmode,
-                                 antennaCws, numPreferredBand, IDEAL, nRus, snr,
-                                 lteinfo->getSourceId());
+                             // compute the feedback for this link
+                             fb_ = lteFeedbackComputation_->computeFeedback(type, rbtype, txmode,
+                                     antennaCws, numPreferredBand, IDEAL, nRus, snr,
+                                     lteinfo->getSourceId());
 
-                         pkt->setLteFeedbackDoubleVectorD2D(peerId, fb_);
+                             pkt->setLteFeedbackDoubleVectorD2D(peerId, fb_);
+                        }
                     }
                 }
             }
@@ -498,6 +498,33 @@ void LtePhyUe::deleteOldBuffers(MacNodeId masterId)
     rlcUm_->deleteQueues(nodeId_);
 }
 
+LteFeedbackPkt* LtePhyUe::createFeedbackPkt()
+{
+    LteFeedbackPkt* fbPkt = feedbackPool_.get();
+    if (fbPkt == NULL)
+    {
+        fbPkt = new LteFeedbackPkt();
+        fbPkt->setControlInfo(new UserControlInfo());
+    }
+    else
+    {
+        // feedback packets are pooled along with their control info
+        fbPkt->reset();
+        check_and_cast<UserControlInfo*>(fbPkt->getControlInfo())->reset();
+    }
+    return fbPkt;
+}
+
+void LtePhyUe::recycleFeedback(LteFeedbackPkt* pkt)
+{
+    Enter_Method_Silent("recycleFeedback");
+    take(pkt);
+    if (dynamic_cast<UserControlInfo*>(pkt->getControlInfo()) != NULL)
+        feedbackPool_.put(pkt);
+    else
+        delete pkt;
+}
+
 DasFilter* LtePhyUe::getDasFilter()
 {
     return das_;
@@ -509,12 +536,13 @@ void LtePhyUe::sendFeedback(LteFeedbackDoubleVector fbDl, LteFeedbackDoubleVecto
     EV << "LtePhyUe: feedback from Feedback Generator" << endl;
 
     //Create a feedback packet
-    LteFeedbackPkt* fbPkt = new LteFeedbackPkt();
+    LteFeedbackPkt* fbPkt = createFeedbackPkt();
     //Set the feedback
     fbPkt->setLteFeedbackDoubleVectorDl(fbDl);
     fbPkt->setLteFeedbackDoubleVectorDl(fbUl);
     fbPkt->setSourceNodeId(nodeId_);
-    UserControlInfo* uinfo = new UserControlInfo();
+    // the control info travels with the air frame
+    UserControlInfo* uinfo = check_and_cast<UserControlInfo*>(fbPkt->removeControlInfo());
     uinfo->setSourceId(nodeId_);
     uinfo->setDestId(masterId_);
     uinfo->setFrameType(FEEDBACKPKT);
@@ -14,8 +14,10 @@
 #include "DasFilter.h"
 #include "LteMacUe.h"
 #include "LteRlcUm.h"
+#include "LteMessagePool.h"
 
 class DasFilter;
+class LteFeedbackPkt;
 
 class LtePhyUe : public LtePhyBase
 {
@@ -94,6 +96,9 @@ class LtePhyUe : public LtePhyBase
 
     simtime_t lastFeedback_;
 
+    /** Feedback packets given back by the eNB, reused for the following reports */
+    LteMessagePool<LteFeedbackPkt> feedbackPool_;
+
     // for UL interference management
     // store the map of RBs used by the UE for transmission
     struct UsedRBs
@@ -129,6 +134,12 @@ class LtePhyUe : public LtePhyBase
     virtual void triggerHandover();
     virtual void doHandover();
 
+    /**
+     * Returns a feedback packet with its control info attached, reusing
+     * one of the packets given back by the eNB if available
+     */
+    LteFeedbackPkt* createFeedbackPkt();
+
   public:
     LtePhyUe();
     virtual ~LtePhyUe();
@@ -137,6 +148,11 @@ class LtePhyUe : public LtePhyBase
      * Send Feedback, called by feedback generator in DL
      */
     virtual void sendFeedback(LteFeedbackDoubleVector fbDl, LteFeedbackDoubleVector fbUl, FeedbackRequest req);
+    /**
+     * Gives back a feedback packet sent by this UE, once it has been
+     * handled by the eNB, to be reused for the following reports
+     */
+    void recycleFeedback(LteFeedbackPkt* pkt);
     MacNodeId getMasterId() const
     {
         return masterId_;
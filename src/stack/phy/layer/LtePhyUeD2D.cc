@@ -31,6 +31,7 @@ void LtePhyUeD2D::initialize(int stage)
     {
         d2dTxPower_ = par("d2dTxPower");
         d2dMulticastEnableCaptureEffect_ = par("d2dMulticastCaptureEffect");
+        d2dMulticastGroupFanOut_ = par("d2dMulticastGroupFanOut");
         d2dDecodingTimer_ = NULL;
     }
 }
@@ -292,11 +293,48 @@ void LtePhyUeD2D::handleUpperMessage(cMessage* msg)
     // if this is a multicast/broadcast connection, send the frame to all neighbors in the hearing range
     // otherwise, send unicast to the destination
     if (lteInfo->getDirection() == D2D_MULTI)
-        sendBroadcast(frame);
+    {
+        if (d2dMulticastGroupFanOut_)
+            sendMulticast(frame);
+        else
+            sendBroadcast(frame);
+    }
     else
         sendUnicast(frame);
 }
 
+void LtePhyUeD2D::sendMulticast(LteAirFrame *frame)
+{
+    UserControlInfo *ci = check_and_cast<UserControlInfo *>(frame->getControlInfo());
+    const std::set<MacNodeId>* members = binder_->getMulticastGroupMembers(ci->getMulticastGroupId());
+    if (members != NULL)
+    {
+        double range = cc->getInterferenceRange(myRadioRef);
+        std::set<MacNodeId>::const_iterator it = members->begin();
+        for (; it != members->end(); ++it)
+        {
+            if (*it == nodeId_)
+                continue;
+
+            UeInfo* info = binder_->getUeInfo(*it);
+            if (info == NULL || getRadioPosition().distance(info->phy->getCoord()) > range)
+                continue;
+
+            // make sure that nodes that left the simulation do not receive
+            OmnetId destOmnetId = binder_->getOmnetId(*it);
+            if (destOmnetId == 0)
+                continue;
+
+            EV << "LtePhyUeD2D::sendMulticast - sending frame to group member " << *it << endl;
+            cModule *receiver = getSimulation()->getModule(destOmnetId);
+            sendDirect(frame->dup(), 0, frame->getDuration(), receiver, "radioIn");
+        }
+    }
+
+    // the original frame can be deleted
+    delete frame;
+}
+
 void LtePhyUeD2D::storeAirFrame(LteAirFrame* newFrame)
 {
     // implements the capture effect
@@ -481,12 +519,13 @@ void LtePhyUeD2D::sendFeedback(LteFeedbackDoubleVector fbDl, LteFeedbackDoubleVe
     EV << "LtePhyUeD2D: feedback from Feedback Generator" << endl;
 
     //Create a feedback packet
-    LteFeedbackPkt* fbPkt = new LteFeedbackPkt();
+    LteFeedbackPkt* fbPkt = createFeedbackPkt();
     //Set the feedback
     fbPkt->setLteFeedbackDoubleVectorDl(fbDl);
     fbPkt->setLteFeedbackDoubleVectorDl(fbUl);
     fbPkt->setSourceNodeId(nodeId_);
-    UserControlInfo* uinfo = new UserControlInfo();
+    // the control info travels with the air frame
+    UserControlInfo* uinfo = check_and_cast<UserControlInfo*>(fbPkt->removeControlInfo());
     uinfo->setSourceId(nodeId_);
     uinfo->setDestId(masterId_);
     uinfo->setFrameType(FEEDBACKPKT);
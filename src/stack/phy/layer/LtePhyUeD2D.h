@@ -29,11 +29,23 @@ class LtePhyUeD2D : public LtePhyUe
     std::vector<LteAirFrame*> d2dReceivedFrames_; // airframes received in the current TTI. Only one will be decoded
     cMessage* d2dDecodingTimer_;                  // timer for triggering decoding at the end of the TTI. Started
                                                   // when the first airframe is received
+    // send D2D multicast frames to the group members only
+    bool d2dMulticastGroupFanOut_;
+
     void storeAirFrame(LteAirFrame* newFrame);
     LteAirFrame* extractAirFrame();
     void decodeAirFrame(LteAirFrame* frame, UserControlInfo* lteInfo);
     // ---------------------------------------------------------------- //
 
+    /**
+     * Sends a D2D multicast frame to the members of its multicast group
+     * within the interference range. Non-members would discard the frame
+     * anyway, hence they do not receive any copy of it
+     *
+     * @param frame the frame to be sent (deleted on return)
+     */
+    void sendMulticast(LteAirFrame* frame);
+
     virtual void initialize(int stage);
     virtual void handleAirFrame(cMessage* msg);
     virtual void handleUpperMessage(cMessage* msg);
@@ -59,6 +59,17 @@ class LteFeedbackPkt : public LteFeedbackPkt_Base
     void setLteFeedbackDoubleVectorD2D(MacNodeId peerId, LteFeedbackDoubleVector lteFeedbackDoubleVector_);
     void setSourceNodeId(MacNodeId id);
     MacNodeId getSourceNodeId();
+
+    /**
+     * Clears the feedback of a delivered packet, so that it can be sent again
+     */
+    void reset()
+    {
+        lteFeedbackDoubleVectorDl_.clear();
+        lteFeedbackDoubleVectorUl_.clear();
+        lteFeedbackMapDoubleVectorD2D_.clear();
+        sourceNodeId_ = 0;
+    }
 };
 
 #endif
@@ -11,6 +11,9 @@
 #include "LteCommon.h"
 #include "AmTxQueue.h"
 #include "AmRxQueue.h"
+#include "LteBinder.h"
+#include "LteMacBase.h"
+#include "LteProfiler.h"
 
 Define_Module(LteRlcAm);
 
@@ -199,10 +202,16 @@ void LteRlcAm::initialize()
     up_[OUT] = gate("AM_Sap_up$o");
     down_[IN] = gate("AM_Sap_down$i");
     down_[OUT] = gate("AM_Sap_down$o");
+
+    profiler_ = getBinder()->getProfiler();
+    if (profiler_ != NULL)
+        mac_ = check_and_cast<LteMacBase*>(getParentModule()->getParentModule()->getSubmodule("mac"));
 }
 
 void LteRlcAm::handleMessage(cMessage* msg)
 {
+    LteProfilerScope prof(profiler_, (profiler_ != NULL) ? mac_->getMacCellId() : 0, PROF_RLC);
+
     cPacket* pkt = check_and_cast<cPacket *>(msg);
     EV << NOW << " LteRlcAm : Received packet " << pkt->getName() << " from port "
        << pkt->getArrivalGate()->getName() << endl;
@@ -14,6 +14,8 @@
 #include "LteCommon.h"
 
 class AmTxQueue;
+class LteProfiler;
+class LteMacBase;
 class AmRxQueue;
 
 /**
@@ -47,9 +49,17 @@ class LteRlcAm : public cSimpleModule
     cGate* up_[2];
     cGate* down_[2];
 
+    /// Per-stage TTI profiler (NULL when profiling is disabled)
+    LteProfiler* profiler_;
+
+    /// MAC of this node, used to charge the RLC time to the serving cell
+    LteMacBase* mac_;
+
   public:
     LteRlcAm()
     {
+        profiler_ = NULL;
+        mac_ = NULL;
     }
     virtual ~LteRlcAm()
     {
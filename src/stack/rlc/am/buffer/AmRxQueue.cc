@@ -22,6 +22,9 @@ AmRxQueue::AmRxQueue() :
     rxWindowDesc_.seqNum_ = 0;
     lastSentAck_ = 0;
     firstSdu_ = 0;
+    rxWindowHead_ = 0;
+    bufferedPdus_ = 0;
+    receivedRun_ = 0;
 
     // in order create a back connection (AM CTRL) , a flow control
     // info for sending ctrl messages to tx entity is required
@@ -88,15 +91,8 @@ void AmRxQueue::handleMessage(cMessage* msg)
     sendStatusReport();
 
     // Reschedule the timer if there are PDUs in the buffer
-
-    for (unsigned int i = 0; i < rxWindowDesc_.windowSize_; i++)
-    {
-        if (pduBuffer_.get(i) != 0)
-        {
-            timer_.start(statusReportInterval_);
-            break;
-        }
-    }
+    if (bufferedPdus_ > 0)
+        timer_.start(statusReportInterval_);
 }
 
 void AmRxQueue::discard(const int sn)
@@ -114,11 +110,12 @@ void AmRxQueue::discard(const int sn)
 
     for (int i = 0; i <= index; ++i)
     {
-        discarded_.at(i) = true;
+        discarded_.at(slot(i)) = true;
 
-        if (pduBuffer_.get(i) != NULL)
+        if (pduBuffer_.get(slot(i)) != NULL)
         {
-            LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(i));
+            LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(slot(i)));
+            --bufferedPdus_;
             FlowControlInfo* ci = check_and_cast<FlowControlInfo*>(pdu->getControlInfo());
             dir = (Direction) ci->getDirection();
             dstId = ci->getDestId();
@@ -278,7 +275,7 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
 
         // Check if the PDU has already been received
 
-        if (received_.at(index) == true)
+        if (received_.at(slot(index)) == true)
         {
             EV << NOW << " AmRxQueue::enque the received PDU has index " << index << " which points to an already busy location" << endl;
 
@@ -286,7 +283,7 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
             // to the same data structure of the PDU
             // stored in the buffer
 
-            LteRlcAmPdu* bufferedpdu = check_and_cast<LteRlcAmPdu*>( pduBuffer_.get(index));
+            LteRlcAmPdu* bufferedpdu = check_and_cast<LteRlcAmPdu*>( pduBuffer_.get(slot(index)));
 
             if (bufferedpdu->getSnoMainPacket() == pdu->getSnoMainPacket())
             {
@@ -304,8 +301,10 @@ void AmRxQueue::enque(LteRlcAmPdu* pdu)
         else
         {
             // Buffer the PDU
-            pduBuffer_.addAt(index, pdu);
-            received_.at(index) = true;
+            pduBuffer_.addAt(slot(index), pdu);
+            received_.at(slot(index)) = true;
+            ++bufferedPdus_;
+            updateReceivedRun();
             // Check if this PDU forms a complete SDU
             checkCompleteSdu(index);
         }
@@ -319,13 +318,13 @@ void AmRxQueue::passUp(const int index)
     LteRlcAm* lteRlc = check_and_cast<LteRlcAm *>(getParentModule()->getSubmodule("am"));
 
     // duplicate buffered PDU. We cannot detach it from receiver window until a move Rx command is executed.
-    LteRlcAmPdu* bufferedpdu = (check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(index)))->dup();
+    LteRlcAmPdu* bufferedpdu = (check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(slot(index))))->dup();
 
     EV << NOW << " AmRxQueue::passUp passing up SDU[" << bufferedpdu->getSnoMainPacket() << "] referenced by PDU at position " << index << endl;
 
     // duplicate buffered PDU control info too.
     FlowControlInfo * ci = check_and_cast<FlowControlInfo*>(
-        (check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(index)))->getControlInfo()->dup());
+        (check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(slot(index))))->getControlInfo()->dup());
 
     int origPktSize = bufferedpdu->getEncapsulatedPacket()->getEncapsulatedPacket()->getByteLength();
 
@@ -386,7 +385,7 @@ void AmRxQueue::passUp(const int index)
 
 void AmRxQueue::checkCompleteSdu(const int index)
 {
-    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(index));
+    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(slot(index)));
     int incomingSdu = pdu->getSnoMainPacket();
 
     EV << NOW << " AmRxQueue::checkCompleteSdu at position " << index << " for SDU number " << incomingSdu << endl;
@@ -433,7 +432,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
                 // check for previous PDUs
                 for (int i = index - 1; i >= 0; i--)
                 {
-                    if (received_.at(i) == false)
+                    if (received_.at(slot(i)) == false)
                     {
                         // There is NO RLC PDU in this position
                         // The SDU is not complete
@@ -442,7 +441,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
                     }
                     else
                     {
-                        tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(i));
+                        tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(slot(i)));
                         tempSdu = tempPdu->getSnoMainPacket();
 
                         if (tempSdu != incomingSdu)
@@ -459,8 +458,8 @@ void AmRxQueue::checkCompleteSdu(const int index)
                             || tempPdu->isWhole())
                         {
                             throw cRuntimeError("AmRxQueue::checkCompleteSdu(): backward search: sequence error, found last or whole PDU [%d] preceding a middle one [%d], belonging to  SDU [%d], current SDU is [%d]",tempPdu->getSnoFragment(),(check_and_cast<LteRlcAmPdu*>(
-                                        pduBuffer_.get(i+1)))->getSnoFragment(),(check_and_cast<LteRlcAmPdu*>(
-                                        pduBuffer_.get(i+1)))->getSnoMainPacket(),tempSdu);
+                                        pduBuffer_.get(slot(i+1))))->getSnoFragment(),(check_and_cast<LteRlcAmPdu*>(
+                                        pduBuffer_.get(slot(i+1))))->getSnoMainPacket(),tempSdu);
                         }
                     }
                 }
@@ -496,7 +495,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
 
     for (int i = index + 1; i < (rxWindowDesc_.windowSize_); ++i)
     {
-        if (received_.at(i) == false)
+        if (received_.at(slot(i)) == false)
         {
             EV << NOW << " AmRxQueue::checkCompleteSdu forward search failed, no PDU at position " << i << " corresponding to"
             " SN  " << i+rxWindowDesc_.firstSeqNum_ << endl;
@@ -507,7 +506,7 @@ void AmRxQueue::checkCompleteSdu(const int index)
         }
         else
         {
-            tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(i));
+            tempPdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.get(slot(i)));
             tempSdu = tempPdu->getSnoMainPacket();
             if (tempSdu != incomingSdu)
             throw cRuntimeError("AmRxQueue::checkCompleteSdu(): SDU numbers differ from position %d to %d : former SDU %d second %d",i,i-1,incomingSdu,tempSdu);
@@ -554,23 +553,13 @@ void AmRxQueue::sendStatusReport()
         return;
     }
 
-        // Compute cumulative ACK
-    int cumulative = 0;
-    bool hole = !received_.at(0);
+    // Compute cumulative ACK: it is kept up to date upon PDU reception
+    // and window shift, so only the bitmap has to be built here
+    int cumulative = receivedRun_;
     std::vector<bool> bitmap;
 
-    for (int i = 0; i < rxWindowDesc_.windowSize_; ++i)
-    {
-        if ((received_.at(i) == true) && !hole)
-        {
-            cumulative++;
-        }
-        else if ((cumulative > 0) || hole)
-        {
-            hole = true;
-            bitmap.push_back(received_.at(i));
-        }
-    }
+    for (int i = cumulative; i < rxWindowDesc_.windowSize_; ++i)
+        bitmap.push_back(received_.at(slot(i)));
 
     // The BitMap :
     // Starting from the cumulative ACK the next received PDU
@@ -628,7 +617,7 @@ int AmRxQueue::computeWindowShift() const
     int shift = 0;
     for ( int i = 0; i < rxWindowDesc_.windowSize_; ++i)
     {
-        if (received_.at(i) == true || discarded_.at(i) == true)
+        if (received_.at(slot(i)) == true || discarded_.at(slot(i)) == true)
         {
             ++shift;
         }
@@ -663,9 +652,10 @@ void AmRxQueue::moveRxWindow(const int seqNum)
 
     for ( int i = 0; i < pos; ++i)
     {
-        if (pduBuffer_.get(i) != NULL)
+        if (pduBuffer_.get(slot(i)) != NULL)
         {
-            pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(i));
+            pdu = check_and_cast<LteRlcAmPdu*>(pduBuffer_.remove(slot(i)));
+            --bufferedPdus_;
             currentSdu = (pdu->getSnoMainPacket());
 
             if (pdu->isLast() || pdu->isWhole())
@@ -679,23 +669,15 @@ void AmRxQueue::moveRxWindow(const int seqNum)
         {
             currentSdu = -1;
         }
+        // free the location, it will host the PDUs entering the window
+        received_.at(slot(i)) = false;
+        discarded_.at(slot(i)) = false;
     }
 
-    for ( int i = pos; i < rxWindowDesc_.windowSize_; ++i)
-    {
-        if (pduBuffer_.get(i) != NULL)
-        {
-            pduBuffer_.addAt(i-pos, pduBuffer_.remove(i));
-        }
-        else
-        {
-            pduBuffer_.remove(i);
-        }
-        received_.at(i-pos) = received_.at(i);
-        discarded_.at(i-pos) = discarded_.at(i);
-        received_.at(i) = false;
-        discarded_.at(i) = false;
-    }
+    // the remaining PDUs are left in place, just advance the window head
+    rxWindowHead_ = slot(pos);
+    receivedRun_ = (receivedRun_ > pos) ? receivedRun_ - pos : 0;
+    updateReceivedRun();
 
     rxWindowDesc_.firstSeqNum_ += pos;
 
@@ -707,6 +689,12 @@ void AmRxQueue::moveRxWindow(const int seqNum)
        << firstSdu_ << endl;
 }
 
+void AmRxQueue::updateReceivedRun()
+{
+    while (receivedRun_ < rxWindowDesc_.windowSize_ && received_.at(slot(receivedRun_)))
+        ++receivedRun_;
+}
+
 AmRxQueue::~AmRxQueue()
 {
 }
@@ -39,8 +39,20 @@ class AmRxQueue : public cSimpleModule
     TTimer timer_;
 
     //! AM PDU buffer
+    /** The buffer is used circularly: the PDU at window index i is
+     *  stored at location (rxWindowHead_ + i) % windowSize_.
+     */
     cArray pduBuffer_;
 
+    //! Buffer location holding the first PDU of the rx window
+    int rxWindowHead_;
+
+    //! Number of PDUs currently stored in the buffer
+    int bufferedPdus_;
+
+    //! Number of consecutive PDUs received from the beginning of the rx window
+    int receivedRun_;
+
     //! AM PDU Received vector
     /** For each AM PDU a received status variable is kept.
      */
@@ -86,6 +98,15 @@ class AmRxQueue : public cSimpleModule
 
   protected:
 
+    //! Map a window index to its location in the circular buffer
+    int slot(const int index) const
+    {
+        return (rxWindowHead_ + index) % rxWindowDesc_.windowSize_;
+    }
+
+    //! Extend the count of consecutive received PDUs at the window start
+    void updateReceivedRun();
+
     //! Send the RLC SDU stored in the buffer to the upper layer
     /** Note that, the buffer contains a set of RLC PDU. At most,
      *  one RLC SDU can be in the buffer!
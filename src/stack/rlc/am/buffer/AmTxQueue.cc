@@ -19,6 +19,8 @@ AmTxQueue::AmTxQueue() :
     currentSdu_ = NULL;
 
     lteInfo_ = NULL;
+    txWindowHead_ = 0;
+    txWindowCompleted_ = 0;
     //initialize timer IDs
     pduTimer_.setTimerId(PDU_T);
     mrwTimer_.setTimerId(MRW_T);
@@ -125,17 +127,18 @@ void AmTxQueue::addPdus()
         pdu->setTxNumber(0);
         // try the insertion into tx buffer
         int txWindowIndex = txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_;
+        int txSlot = slot(txWindowIndex);
 
-        if (pduRtxQueue_.get(txWindowIndex) == NULL)
+        if (pduRtxQueue_.get(txSlot) == NULL)
         {
             // store a copy of current PDU
             LteRlcAmPdu * pduCopy = pdu->dup();
             pduCopy->setControlInfo(lteInfo->dup());
-            pduRtxQueue_.addAt(txWindowIndex, pduCopy);
+            pduRtxQueue_.addAt(txSlot, pduCopy);
 
-            if (received_.at(txWindowIndex) || discarded_.at(txWindowIndex))
+            if (received_.at(txSlot) || discarded_.at(txSlot))
             throw cRuntimeError("AmTxQueue::addPdus(): trying to add a PDU to a  position marked received [%d] discarded [%d]",
-                (int)(received_.at(txWindowIndex)) ,(int)(discarded_.at(txWindowIndex)));
+                (int)(received_.at(txSlot)) ,(int)(discarded_.at(txSlot)));
         }
         else
         {
@@ -183,7 +186,7 @@ void AmTxQueue::discard(const int seqNum)
             seqNum, txWindowDesc_.firstSeqNum_);
     }
 
-    if (discarded_.at(txWindowIndex) == true)
+    if (discarded_.at(slot(txWindowIndex)) == true)
     {
         EV << " AmTxQueue::discard requested to discard an already discarded  PDU :"
         " sequence number" << seqNum << " , window first sequence is " << txWindowDesc_.firstSeqNum_ << endl;
@@ -191,11 +194,11 @@ void AmTxQueue::discard(const int seqNum)
     else
     {
         // mark current PDU for discard
-        discarded_.at(txWindowIndex) = true;
+        discarded_.at(slot(txWindowIndex)) = true;
     }
 
     LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(
-        pduRtxQueue_.get(txWindowIndex));
+        pduRtxQueue_.get(slot(txWindowIndex)));
 
     if (pduTimer_.busy(seqNum))
         pduTimer_.remove(seqNum);
@@ -205,15 +208,15 @@ void AmTxQueue::discard(const int seqNum)
     for (int i = (txWindowIndex + 1);
         i < (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_); ++i)
     {
-        if (pduRtxQueue_.get(i) != NULL)
+        if (pduRtxQueue_.get(slot(i)) != NULL)
         {
-            nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(i));
+            nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(slot(i)));
             if (pdu->getSnoMainPacket() == nextPdu->getSnoMainPacket())
             {
                 // Mark the PDU to be discarded
-                if (!discarded_.at(i))
+                if (!discarded_.at(slot(i)))
                 {
-                    discarded_.at(i) = true;
+                    discarded_.at(slot(i)) = true;
                     // Stop the timer
                     if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
                         pduTimer_.remove(i + txWindowDesc_.firstSeqNum_);
@@ -231,17 +234,17 @@ void AmTxQueue::discard(const int seqNum)
     // Check backward in the buffer if there are other PDUs related to the same SDU
     for (int i = txWindowIndex - 1; i >= 0; i--)
     {
-        if (pduRtxQueue_.get(i) == NULL)
+        if (pduRtxQueue_.get(slot(i)) == NULL)
             throw cRuntimeError("AmTxBuffer::discard(): trying to get access to missing PDU %d", i);
 
-        nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(i));
+        nextPdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(slot(i)));
 
         if (pdu->getSnoMainPacket() == nextPdu->getSnoMainPacket())
         {
-            if (!discarded_.at(i))
+            if (!discarded_.at(slot(i)))
             {
                 // Mark the PDU to be discarded
-                discarded_.at(i) = true;
+                discarded_.at(slot(i)) = true;
             }
             // Stop the timer
             if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
@@ -261,26 +264,21 @@ void AmTxQueue::checkForMrw()
     EV << NOW << " AmTxQueue::checkForMrw " << endl;
 
     // If there is a discarded RLC PDU at the beginning of the buffer, try
-    // to move the transmitter window
-    int lastPdu = 0;
-    bool toMove = false;
-
-    for (int i = 0; i < (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_); ++i)
+    // to move the transmitter window. PDUs are never un-acked or un-discarded
+    // while in the window, so the completed prefix only has to be extended.
+    while (txWindowCompleted_ < (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_))
     {
-        if ((discarded_.at(i) == true) || (received_.at(i) == true))
-        {
-            lastPdu = i;
-            toMove = true;
-        }
-        else
-        {
+        int i = slot(txWindowCompleted_);
+
+        if ((discarded_.at(i) == false) && (received_.at(i) == false))
             break;
-        }
+
+        ++txWindowCompleted_;
     }
 
-    if (toMove == true)
+    if (txWindowCompleted_ > 0)
     {
-        int lastSn = txWindowDesc_.firstSeqNum_ + lastPdu;
+        int lastSn = txWindowDesc_.firstSeqNum_ + txWindowCompleted_ - 1;
 
         EV << NOW << " AmTxQueue::checkForMrw  detected a shift from " << lastSn << endl;
 
@@ -301,18 +299,19 @@ void AmTxQueue::moveTxWindow(const int seqNum)
     EV << NOW << " AmTxQueue::moveTxWindow sequence number " << seqNum
        << " corresponding index " << pos << endl;
 
-    // Delete both discarded and received RLC PDUs
+    // Delete both discarded and received RLC PDUs. The remaining PDUs are left in
+    // place: the window head is advanced past the freed locations instead.
     LteRlcAmPdu* pdu = NULL;
 
     for (int i = 0; i < pos; ++i)
     {
-        if (pduRtxQueue_.get(i) != NULL)
+        if (pduRtxQueue_.get(slot(i)) != NULL)
         {
             EV << NOW << " AmTxQueue::moveTxWindow deleting PDU ["
                << i + txWindowDesc_.firstSeqNum_
                << "] corresponding index " << i << endl;
 
-            pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(i));
+            pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(slot(i)));
             delete pdu;
             // Stop the rtx timer event
             if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
@@ -322,73 +321,21 @@ void AmTxQueue::moveTxWindow(const int seqNum)
                    << i + txWindowDesc_.firstSeqNum_
                    << "] corresponding index " << i << endl;
             }
-            received_.at(i)=false;
-            discarded_.at(i)=false;
+            received_.at(slot(i))=false;
+            discarded_.at(slot(i))=false;
         }
         else
         throw cRuntimeError("AmTxQueue::moveTxWindow(): encountered empty PDU at location %d, shift position %d", i, pos);
     }
 
-    for (int i = pos;
-        i < ((txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_)); ++i)
-    {
-        if (pduRtxQueue_.get(i) != NULL)
-        {
-            pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(i));
-            pduRtxQueue_.addAt(i - pos, pdu);
-
-            EV << NOW << " AmTxQueue::moveTxWindow  PDU ["
-               << i + txWindowDesc_.firstSeqNum_
-               << "] corresponding index " << i
-               << " being moved at position " << i - pos << endl;
-        }
-        else
-        {
-            throw cRuntimeError("AmTxQueue::moveTxWindow(): encountered empty PDU at location %d, shift position %d", i, pos);
-        }
-
-        EV << NOW << " AmTxQueue::moveTxWindow  PDU ["
-           << i + txWindowDesc_.firstSeqNum_
-           << "] corresponding new index " << i - pos
-           << " marked as received [" << (received_.at(i - pos))
-           << "] , discarded [" << (discarded_.at(i - pos)) << "]" << endl;
-
-        received_.at(i - pos) = received_.at(i);
-        discarded_.at(i - pos) = discarded_.at(i);
-
-        received_.at(i) = false;
-        discarded_.at(i) = false;
-
-        EV << NOW << " AmTxQueue::moveTxWindow  location [" << i
-           << "] corresponding new PDU "
-           << i + pos + txWindowDesc_.firstSeqNum_
-           << " marked as received [" << (received_.at(i))
-           << "] , discarded [" << (discarded_.at(i)) << "]" << endl;
-    }
-
-            // cleanup
-    for (int i = (txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_);
-        i < txWindowDesc_.windowSize_; ++i)
-    {
-        if (pduRtxQueue_.get(i) != NULL)
-            throw cRuntimeError("AmTxQueue::moveTxWindow(): encountered busy PDU at location %d, shift position %d", i,
-                pos);
-
-        EV << NOW << " AmTxQueue::moveTxWindow  empty location [" << i
-           << "] marked as received [" << (received_.at(i))
-           << "] , discarded [" << (discarded_.at(i)) << "]" << endl;
-
-        received_.at(i) = false;
-        discarded_.at(i) = false;
-    }
-
+    txWindowHead_ = slot(pos);
+    txWindowCompleted_ = (txWindowCompleted_ > pos) ? txWindowCompleted_ - pos : 0;
     txWindowDesc_.firstSeqNum_ += pos;
 
     EV << NOW << " AmTxQueue::moveTxWindow completed. First sequence number "
        << txWindowDesc_.firstSeqNum_ << " current sequence number "
-       << txWindowDesc_.seqNum_ << " cleaned up locations from "
-       << txWindowDesc_.seqNum_ - txWindowDesc_.firstSeqNum_ << " to "
-       << txWindowDesc_.windowSize_ - 1 << endl;
+       << txWindowDesc_.seqNum_ << " window head at location "
+       << txWindowHead_ << endl;
 
     // Try to add more PDUs to the buffer
     addPdus();
@@ -509,7 +456,7 @@ void AmTxQueue::recvAck(const int seqNum)
     if (index >= txWindowDesc_.windowSize_)
         throw cRuntimeError("AmTxBuffer::recvAck(): ACK greater than window size %d", txWindowDesc_.windowSize_);
 
-    if (!(received_.at(index)))
+    if (!(received_.at(slot(index))))
     {
         EV << NOW << " AmTxBuffer::recvAck canceling timer for PDU "
            << (index + txWindowDesc_.firstSeqNum_) << " index " << index << endl;
@@ -517,7 +464,7 @@ void AmTxQueue::recvAck(const int seqNum)
         if (pduTimer_.busy(index + txWindowDesc_.firstSeqNum_))
         pduTimer_.remove(index + txWindowDesc_.firstSeqNum_);
         // Received status variable is set at true after the
-        received_.at(index) = true;
+        received_.at(slot(index)) = true;
     }
 }
 
@@ -537,9 +484,10 @@ void AmTxQueue::recvCumulativeAck(const int seqNum)
     }
     else
     {
-        // The ACK is inside the window
+        // The ACK is inside the window: PDUs in the completed prefix have
+        // already been acked or discarded, and their timers stopped
 
-        for (int i = 0; i <= (seqNum - txWindowDesc_.firstSeqNum_); ++i)
+        for (int i = txWindowCompleted_; i <= (seqNum - txWindowDesc_.firstSeqNum_); ++i)
         {
             EV << NOW
                << " AmTxBuffer::recvCumulativeAck ACK received for sequence number "
@@ -549,7 +497,7 @@ void AmTxQueue::recvCumulativeAck(const int seqNum)
             "index [" << i << "] " << endl;
 
             // the ACK could have already been received
-            if (!(received_.at(i)))
+            if (!(received_.at(slot(i))))
             {
                 // canceling timer for PDU
                 EV << NOW
@@ -559,7 +507,7 @@ void AmTxQueue::recvCumulativeAck(const int seqNum)
                 if (pduTimer_.busy(i + txWindowDesc_.firstSeqNum_))
                 pduTimer_.remove(i + txWindowDesc_.firstSeqNum_);
                 // Received status variable is set at true after the
-                received_.at(i) = true;
+                received_.at(slot(i)) = true;
             }
         }
         checkForMrw();
@@ -611,16 +559,16 @@ void AmTxQueue::pduTimerHandle(const int sn)
             "AmTxQueue::pduTimerHandle(): The PDU [%d] for which timer elapsed is out of the window : index [%d]", sn,
             index);
 
-    if (pduRtxQueue_.get(index) == NULL)
+    if (pduRtxQueue_.get(slot(index)) == NULL)
         throw cRuntimeError("AmTxQueue::pduTimerHandle(): PDU %d not found", index);
 
     // Check if the PDU has been correctly received, if so the
     // timer should have been previously stopped.
-    if (received_.at(index) == true)
+    if (received_.at(slot(index)) == true)
         throw cRuntimeError(" AmTxQueue::pduTimerHandle(): The PDU %d [index %d] has been already received", sn, index);
 
     // Get the PDU information
-    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(index));
+    LteRlcAmPdu* pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.get(slot(index)));
 
     int nextTxNumber = pdu->getTxNumber() + 1;
 
@@ -636,7 +584,7 @@ void AmTxQueue::pduTimerHandle(const int sn)
     {
         EV << NOW << " AmTxQueue::pduTimerHandle starting new transmission" << endl;
         // extract PDU from buffer
-        pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(index));
+        pdu = check_and_cast<LteRlcAmPdu*>(pduRtxQueue_.remove(slot(index)));
         // A new transmission can be started
         pdu->setTxNumber(nextTxNumber);
         // The RLC PDU is added to the retransmission buffer
@@ -644,7 +592,7 @@ void AmTxQueue::pduTimerHandle(const int sn)
         // .. with control info also!
         copy->setControlInfo(pdu->getControlInfo()->dup());
 
-        pduRtxQueue_.add(copy);
+        pduRtxQueue_.addAt(slot(index), copy);
         // Reschedule the timer
         pduTimer_.add(pduRtxTimeout_, sn);
         // send down the PDU
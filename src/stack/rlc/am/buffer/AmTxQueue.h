@@ -79,6 +79,12 @@ class AmTxQueue : public cSimpleModule
     // Transmission window descriptor
     RlcWindowDesc txWindowDesc_;
 
+    // Buffer location holding the first PDU of the transmission window
+    int txWindowHead_;
+
+    // Number of PDUs at the beginning of the window already acknowledged or discarded
+    int txWindowCompleted_;
+
     // Move receive window command descriptor
     MrwDesc mrwDesc_;
 
@@ -150,6 +156,14 @@ class AmTxQueue : public cSimpleModule
      */
     void discard(int seqNum);
 
+    /* Maps a window index to its location in the (circular) transmission buffer
+     *
+     * @param index position relative to the first sequence number of the window
+     */
+    int slot(const int index) const
+    {
+        return (txWindowHead_ + index) % txWindowDesc_.windowSize_;
+    }
     /* Move the transmitter window based upon reception of ACK control message
      *
      * @param seqNum
@@ -9,6 +9,9 @@
 
 #include "LteRlcUm.h"
 #include "D2DModeSwitchNotification_m.h"
+#include "LteBinder.h"
+#include "LteMacBase.h"
+#include "LteProfiler.h"
 
 Define_Module(LteRlcUm);
 
@@ -184,12 +187,23 @@ void LteRlcUm::initialize()
     down_[IN] = gate("UM_Sap_down$i");
     down_[OUT] = gate("UM_Sap_down$o");
 
+    initProfiler();
+
     WATCH_MAP(txBuffers_);
     WATCH_MAP(rxBuffers_);
 }
 
+void LteRlcUm::initProfiler()
+{
+    profiler_ = getBinder()->getProfiler();
+    if (profiler_ != NULL)
+        mac_ = check_and_cast<LteMacBase*>(getParentModule()->getParentModule()->getSubmodule("mac"));
+}
+
 void LteRlcUm::handleMessage(cMessage* msg)
 {
+    LteProfilerScope prof(profiler_, (profiler_ != NULL) ? mac_->getMacCellId() : 0, PROF_RLC);
+
     cPacket* pkt = check_and_cast<cPacket *>(msg);
     EV << "LteRlcUm : Received packet " << pkt->getName() <<
     " from port " << pkt->getArrivalGate()->getName() << endl;
@@ -18,6 +18,8 @@
 #include "UmRxQueue.h"
 
 class UmTxQueue;
+class LteProfiler;
+class LteMacBase;
 class UmRxQueue;
 
 /**
@@ -46,6 +48,8 @@ class LteRlcUm : public cSimpleModule
   public:
     LteRlcUm()
     {
+        profiler_ = NULL;
+        mac_ = NULL;
     }
     virtual ~LteRlcUm()
     {
@@ -92,11 +96,23 @@ class LteRlcUm : public cSimpleModule
     cGate* up_[2];
     cGate* down_[2];
 
+    /// Per-stage TTI profiler (NULL when profiling is disabled)
+    LteProfiler* profiler_;
+
+    /// MAC of this node, used to charge the RLC time to the serving cell
+    LteMacBase* mac_;
+
     /**
      * Initialize watches
      */
     virtual void initialize();
 
+    /**
+     * Fetches the TTI profiler from the binder (and the
+     * local MAC, when profiling is enabled)
+     */
+    void initProfiler();
+
     /**
      * Analyze gate of incoming packet
      * and call proper handler
@@ -229,6 +229,8 @@ void LteRlcUmRealistic::initialize()
     down_[IN] = gate("UM_Sap_down$i");
     down_[OUT] = gate("UM_Sap_down$o");
 
+    initProfiler();
+
     WATCH_MAP(txEntities_);
     WATCH_MAP(rxEntities_);
 }
@@ -80,7 +80,7 @@ class LteRlcUmRealistic : public LteRlcUm
      * @return pointer to the TXBuffer for the CID of the flow
      *
      */
-    UmTxEntity* getTxBuffer(FlowControlInfo* lteInfo);
+    virtual UmTxEntity* getTxBuffer(FlowControlInfo* lteInfo);
 
     /**
      * getRxBuffer() is used by the receiver to gather the RXBuffer
@@ -92,7 +92,7 @@ class LteRlcUmRealistic : public LteRlcUm
      * @return pointer to the RXBuffer for that CID
      *
      */
-    UmRxEntity* getRxBuffer(FlowControlInfo* lteInfo);
+    virtual UmRxEntity* getRxBuffer(FlowControlInfo* lteInfo);
 
     /**
      * handler for traffic coming
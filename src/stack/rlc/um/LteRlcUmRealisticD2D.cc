@@ -8,7 +8,6 @@
 //
 
 #include "LteRlcUmRealisticD2D.h"
-#include "D2DModeSwitchNotification_m.h"
 
 Define_Module(LteRlcUmRealisticD2D);
 
@@ -25,24 +24,38 @@ void LteRlcUmRealisticD2D::handleLowerMessage(cPacket *pkt)
 
         // add here specific behavior for handling mode switch at the RLC layer
         D2DModeSwitchNotification* switchPkt = check_and_cast<D2DModeSwitchNotification*>(pkt);
-        FlowControlInfo* lteInfo = check_and_cast<FlowControlInfo*>(switchPkt->getControlInfo());
 
-        if (switchPkt->getTxSide())
+        if (nodeType_ == UE)
+        {
+            // the UE MAC sends a single notification for all the connections with the peer
+            rlcHandleD2DModeSwitch(switchPkt);
+        }
+        else
         {
-            // get the corresponding Rx buffer & call handler
-            UmTxEntity* txbuf = getTxBuffer(lteInfo);
-            txbuf->rlcHandleD2DModeSwitch(switchPkt->getOldConnection());
+            FlowControlInfo* lteInfo = check_and_cast<FlowControlInfo*>(switchPkt->getControlInfo());
 
+            if (switchPkt->getTxSide())
+            {
+                // get the corresponding Tx buffer & call handler
+                UmTxEntity* txbuf = getTxBuffer(lteInfo);
+                txbuf->rlcHandleD2DModeSwitch(switchPkt->getOldConnection());
+            }
+            else
+            {
+                // get the corresponding Rx buffer & call handler
+                UmRxEntity* rxbuf = getRxBuffer(lteInfo);
+                rxbuf->rlcHandleD2DModeSwitch(switchPkt->getOldConnection(), switchPkt->getOldMode());
+            }
+        }
+
+        if (switchPkt->getTxSide())
+        {
             // forward packet to PDCP
             EV << "LteRlcUmRealisticD2D::handleLowerMessage - Sending packet " << pkt->getName() << " to port UM_Sap_up$o\n";
             send(pkt, up_[OUT]);
         }
         else  // rx side
         {
-            // get the corresponding Rx buffer & call handler
-            UmRxEntity* rxbuf = getRxBuffer(lteInfo);
-            rxbuf->rlcHandleD2DModeSwitch(switchPkt->getOldConnection(), switchPkt->getOldMode());
-
             delete switchPkt;
         }
     }
@@ -81,7 +94,91 @@ void LteRlcUmRealisticD2D::initialize(int stage)
         down_[IN] = gate("UM_Sap_down$i");
         down_[OUT] = gate("UM_Sap_down$o");
 
+        initProfiler();
+
         WATCH_MAP(txEntities_);
         WATCH_MAP(rxEntities_);
     }
 }
+
+UmTxEntity* LteRlcUmRealisticD2D::getTxBuffer(FlowControlInfo* lteInfo)
+{
+    unsigned int entities = txEntities_.size();
+    UmTxEntity* txEnt = LteRlcUmRealistic::getTxBuffer(lteInfo);
+
+    // a new entity has been created
+    if (nodeType_ == UE && txEntities_.size() != entities && lteInfo != NULL && lteInfo->getD2dRxPeerId() != 0)
+        peerTxEntities_[lteInfo->getD2dRxPeerId()].push_back(txEnt);
+
+    return txEnt;
+}
+
+UmRxEntity* LteRlcUmRealisticD2D::getRxBuffer(FlowControlInfo* lteInfo)
+{
+    unsigned int entities = rxEntities_.size();
+    UmRxEntity* rxEnt = LteRlcUmRealistic::getRxBuffer(lteInfo);
+
+    // a new entity has been created
+    if (nodeType_ == UE && rxEntities_.size() != entities && lteInfo->getD2dTxPeerId() != 0)
+        peerRxEntities_[lteInfo->getD2dTxPeerId()].push_back(rxEnt);
+
+    return rxEnt;
+}
+
+void LteRlcUmRealisticD2D::rlcHandleD2DModeSwitch(D2DModeSwitchNotification* switchPkt)
+{
+    MacNodeId peerId = switchPkt->getPeerId();
+    LteD2DMode oldMode = switchPkt->getOldMode();
+    LteD2DMode newMode = switchPkt->getNewMode();
+
+    if (switchPkt->getTxSide())
+    {
+        Direction newDirection = (newMode == DM) ? D2D : UL;
+        Direction oldDirection = (oldMode == DM) ? D2D : UL;
+
+        std::map<MacNodeId, std::vector<UmTxEntity*> >::iterator pit = peerTxEntities_.find(peerId);
+        if (pit == peerTxEntities_.end())
+            return;
+
+        std::vector<UmTxEntity*>::iterator it = pit->second.begin();
+        for (; it != pit->second.end(); ++it)
+        {
+            Direction dir = (Direction) (*it)->getFlowControlInfo()->getDirection();
+            if (dir == oldDirection)
+                (*it)->rlcHandleD2DModeSwitch(true);
+            else if (dir == newDirection && oldDirection != newDirection)
+                (*it)->rlcHandleD2DModeSwitch(false);
+        }
+    }
+    else
+    {
+        Direction newDirection = (newMode == DM) ? D2D : DL;
+        Direction oldDirection = (oldMode == DM) ? D2D : DL;
+
+        std::map<MacNodeId, std::vector<UmRxEntity*> >::iterator pit = peerRxEntities_.find(peerId);
+        if (pit == peerRxEntities_.end() || oldDirection == newDirection)
+            return;
+
+        std::vector<UmRxEntity*>::iterator it = pit->second.begin();
+        for (; it != pit->second.end(); ++it)
+        {
+            Direction dir = (Direction) (*it)->getFlowControlInfo()->getDirection();
+            if (dir == oldDirection)
+                (*it)->rlcHandleD2DModeSwitch(true, oldMode);
+            else if (dir == newDirection)
+                (*it)->rlcHandleD2DModeSwitch(false, oldMode);
+        }
+    }
+}
+
+void LteRlcUmRealisticD2D::deleteQueues(MacNodeId nodeId)
+{
+    LteRlcUmRealistic::deleteQueues(nodeId);
+
+    // at the UE, all the entities have been deleted
+    if (nodeType_ == UE)
+    {
+        peerTxEntities_.clear();
+        peerRxEntities_.clear();
+    }
+}
@@ -11,6 +11,7 @@
 #define _LTE_LTERLCUMREALISTICD2D_H_
 
 #include "LteRlcUmRealistic.h"
+#include "D2DModeSwitchNotification_m.h"
 
 /**
  * @class LteRlcUmRealisticD2D
@@ -29,10 +30,25 @@ class LteRlcUmRealisticD2D : public LteRlcUmRealistic
     {
     }
 
+    /**
+     * deleteQueues() must be called on handover
+     * to delete queues for a given user
+     *
+     * @param nodeId Id of the node whose queues are deleted
+     */
+    virtual void deleteQueues(MacNodeId nodeId);
+
   protected:
 
     LteNodeType nodeType_;
 
+    /*
+     * Entities of the UE indexed by D2D peer: TX entities by receiving peer,
+     * RX entities by transmitting peer. Used to handle mode switches
+     */
+    std::map<MacNodeId, std::vector<UmTxEntity*> > peerTxEntities_;
+    std::map<MacNodeId, std::vector<UmRxEntity*> > peerRxEntities_;
+
     virtual int numInitStages() const { return inet::NUM_INIT_STAGES; }
     virtual void initialize(int stage);
     virtual void handleMessage(cMessage *msg);
@@ -53,6 +69,24 @@ class LteRlcUmRealisticD2D : public LteRlcUmRealistic
      * @param pkt packet to process
      */
     virtual void handleLowerMessage(cPacket *pkt);
+
+    /**
+     * Returns the TX entity of the flow and, at the UE,
+     * indexes the new entities by D2D peer
+     */
+    virtual UmTxEntity* getTxBuffer(FlowControlInfo* lteInfo);
+
+    /**
+     * Returns the RX entity of the flow and, at the UE,
+     * indexes the new entities by D2D peer
+     */
+    virtual UmRxEntity* getRxBuffer(FlowControlInfo* lteInfo);
+
+    /**
+     * Dispatches a mode switch notification received by the UE to all
+     * the entities associated to the D2D peer
+     */
+    void rlcHandleD2DModeSwitch(D2DModeSwitchNotification* switchPkt);
 };
 
 #endif
@@ -23,6 +23,7 @@ UmRxEntity::UmRxEntity() :
     lastPduReassembled_ = 0;
     nodeB_ = NULL;
     init_ = false;
+    rxWindowHead_ = 0;
 }
 
 UmRxEntity::~UmRxEntity()
@@ -51,6 +52,7 @@ void UmRxEntity::enque(cPacket* pkt)
         // setting the window size to 1 lets the entity to deliver immediately out-of-sequence SDU,
         // since reordering is not applicable for D2D multicast communications
         rxWindowDesc_.windowSize_ = 1;
+        rxWindowHead_ = 0;
         init_ = true;
     }
 
@@ -60,7 +62,7 @@ void UmRxEntity::enque(cPacket* pkt)
     EV << NOW << " UmRxEntity::enque - tsn " << tsn << ", the corresponding index in the buffer is " << index << endl;
 
     // x was already received
-    if (tsn >= rxWindowDesc_.firstSnoForReordering_ && tsn < rxWindowDesc_.highestReceivedSno_ && received_.at(index) == true)
+    if (tsn >= rxWindowDesc_.firstSnoForReordering_ && tsn < rxWindowDesc_.highestReceivedSno_ && received_.at(slot(index)) == true)
     {
         EV << NOW << " UmRxEntity::enque the received PDU has index " << index << " which points to an already busy location. Discard the PDU" << endl;
 
@@ -127,8 +129,8 @@ void UmRxEntity::enque(cPacket* pkt)
     // buffer the received PDU at the correct position in the buffer
     // get the position in the buffer (the buffer may has been shifted)
     index = tsn - rxWindowDesc_.firstSno_;
-    pduBuffer_.addAt(index, pdu);
-    received_.at(index) = true;
+    pduBuffer_.addAt(slot(index), pdu);
+    received_.at(slot(index)) = true;
 
     // emit statistics
     MacNodeId ueId;
@@ -161,14 +163,14 @@ void UmRxEntity::enque(cPacket* pkt)
     index = rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_; //
 
     // D
-    if (received_.at(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_) == true)
+    if (received_.at(slot(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_)) == true)
     {
         unsigned int old = rxWindowDesc_.firstSnoForReordering_;
 
         index = rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_; //
 
         // move to the first missing SN
-        while (received_.at(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_) == true)
+        while (received_.at(slot(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_)) == true)
         {
             rxWindowDesc_.firstSnoForReordering_++;
             if (rxWindowDesc_.firstSnoForReordering_ == rxWindowDesc_.highestReceivedSno_) // end of the window
@@ -215,19 +217,14 @@ void UmRxEntity::moveRxWindow(const int pos)
     if (pos>rxWindowDesc_.windowSize_)
         throw cRuntimeError("AmRxQueue::moveRxWindow(): positions %d win size %d ",pos,rxWindowDesc_.windowSize_);
 
-    for (unsigned int i = pos; i < rxWindowDesc_.windowSize_; ++i)
+    // the PDUs leaving the window have already been reassembled: free their
+    // locations and advance the window head, leaving the other PDUs in place
+    for (unsigned int i = 0; i < pos; ++i)
     {
-        if (pduBuffer_.get(i) != NULL)
-        {
-            pduBuffer_.addAt(i-pos, pduBuffer_.remove(i));
-        }
-        else
-        {
-            pduBuffer_.remove(i);
-        }
-        received_.at(i-pos) = received_.at(i);
-        received_.at(i) = false;
+        pduBuffer_.remove(slot(i));
+        received_.at(slot(i)) = false;
     }
+    rxWindowHead_ = slot(pos);
 
     rxWindowDesc_.firstSno_ += pos;
 
@@ -321,7 +318,7 @@ void UmRxEntity::toPdcp(LteRlcSdu* rlcSdu)
 
 void UmRxEntity::reassemble(unsigned int index)
 {
-    if (received_.at(index) == false)
+    if (received_.at(slot(index)) == false)
     {
         // consider the case when a PDU is missing or already delivered
         EV << NOW << " UmRxEntity::reassemble PDU at index " << index << " has not been received or already delivered" << endl;
@@ -329,7 +326,7 @@ void UmRxEntity::reassemble(unsigned int index)
     }
     EV << NOW << " UmRxEntity::reassemble Consider PDU at index " << index << " for reassembly" << endl;
 
-    LteRlcUmDataPdu* pdu = check_and_cast<LteRlcUmDataPdu*>(pduBuffer_.get(index));
+    LteRlcUmDataPdu* pdu = check_and_cast<LteRlcUmDataPdu*>(pduBuffer_.get(slot(index)));
     FlowControlInfo* lteInfo = check_and_cast<FlowControlInfo*>(pdu->removeControlInfo());
 
     // get PDU seq number
@@ -629,8 +626,8 @@ void UmRxEntity::reassemble(unsigned int index)
 
     }
     // remove PDU from buffer
-    pduBuffer_.remove(index);
-    received_.at(index) = false;
+    pduBuffer_.remove(slot(index));
+    received_.at(slot(index)) = false;
     EV << NOW << " UmRxEntity::reassemble Removed PDU from position " << index << endl;
 
     // emit statistics
@@ -758,7 +755,7 @@ void UmRxEntity::handleMessage(cMessage* msg)
         unsigned int old = rxWindowDesc_.firstSnoForReordering_;
 
         // move to the first missing SN
-        while (received_.at(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_) == true
+        while (received_.at(slot(rxWindowDesc_.firstSnoForReordering_-rxWindowDesc_.firstSno_)) == true
                  || rxWindowDesc_.firstSnoForReordering_ < rxWindowDesc_.reorderingSno_)
         {
             rxWindowDesc_.firstSnoForReordering_++;
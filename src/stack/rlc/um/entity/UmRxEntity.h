@@ -95,9 +95,13 @@ class UmRxEntity : public cSimpleModule
      */
     FlowControlInfo* flowControlInfo_;
 
-    // The PDU enqueue buffer.
+    // The PDU enqueue buffer. It is used circularly: the PDU at window
+    // index i is stored at location (rxWindowHead_ + i) % windowSize_
     cArray pduBuffer_;
 
+    // Buffer location holding the first PDU of the reordering window
+    unsigned int rxWindowHead_;
+
     // State variables
     RlcUmRxWindowDesc rxWindowDesc_;
 
@@ -126,6 +130,12 @@ class UmRxEntity : public cSimpleModule
     // useful for D2D after a mode switch
     bool resetFlag_;
 
+    // map a window index to its location in the circular buffer
+    unsigned int slot(unsigned int index) const
+    {
+        return (rxWindowHead_ + index) % rxWindowDesc_.windowSize_;
+    }
+
     // move forward the reordering window
     void moveRxWindow(const int pos);
 
@@ -59,6 +59,17 @@ void ChannelAccess::initialize(int stage)
         positionUpdateArrived = false;
         // register to get a notification when position changes
         hostModule->subscribe(inet::IMobility::mobilityStateChangedSignal, this);
+
+        // with lazy positions the mobility model is queried when the position is needed,
+        // so that it does not need to be configured with periodic updates (updateInterval = 0)
+        lazyPosition = hasPar("lazyMobility") && par("lazyMobility").boolValue();
+        if (lazyPosition)
+        {
+            mobility = dynamic_cast<IMobility*>(hostModule->getSubmodule("mobility"));
+            if (mobility == NULL)
+                error("lazyMobility is set, but host '%s' has no mobility submodule", hostModule->getFullPath().c_str());
+            lastPositionRefresh = -1;
+        }
     }
     else if (stage == inet::INITSTAGE_PHYSICAL_ENVIRONMENT_2)
     {
@@ -108,6 +119,22 @@ void ChannelAccess::sendToChannel(AirFrame *msg)
     cc->sendToChannel(myRadioRef, msg);
 }
 
+void ChannelAccess::refreshPosition()
+{
+    if (mobility == NULL || myRadioRef == NULL || lastPositionRefresh == simTime())
+        return;
+    lastPositionRefresh = simTime();
+
+    // closed-form mobility models compute the position at the current time;
+    // this may also come back through receiveSignal()
+    Coord pos = mobility->getCurrentPosition();
+    if (pos != radioPos)
+    {
+        radioPos = pos;
+        cc->setRadioPosition(myRadioRef, radioPos);
+    }
+}
+
 void ChannelAccess::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *)
 {
     if (signalID == inet::IMobility::mobilityStateChangedSignal)
@@ -30,6 +30,7 @@
 
 // Forward declarations
 class AirFrame;
+namespace inet { class IMobility; }
 
 /**
  * @brief Basic class for all physical layers, please don't touch!!
@@ -56,9 +57,12 @@ class INET_API ChannelAccess : public cSimpleModule, public cListener
     cModule *hostModule;    // the host that contains this radio model
     Coord radioPos;  // the physical position of the radio (derived from display string or from mobility models)
     bool positionUpdateArrived;
+    bool lazyPosition;  // if true, the position is read from the mobility model when it is needed
+    inet::IMobility *mobility;  // mobility model of the host, used when lazyPosition is set
+    simtime_t lastPositionRefresh;  // time of the last position refresh, used when lazyPosition is set
 
   public:
-    ChannelAccess() : cc(NULL), myRadioRef(NULL), hostModule(NULL) {}
+    ChannelAccess() : cc(NULL), myRadioRef(NULL), hostModule(NULL), lazyPosition(false), mobility(NULL) {}
     virtual ~ChannelAccess();
 
     /**
@@ -76,7 +80,19 @@ class INET_API ChannelAccess : public cSimpleModule, public cListener
     virtual void sendToChannel(AirFrame *msg);
 
     virtual cPar& getChannelControlPar(const char *parName) { return dynamic_cast<cModule *>(cc)->par(parName); }
-    const Coord& getRadioPosition() const { return radioPos; }
+    const Coord& getRadioPosition()
+    {
+        if (lazyPosition)
+            refreshPosition();
+        return radioPos;
+    }
+
+    /**
+     * Reads the current position from the mobility model (at most once per
+     * simulation time) and updates ChannelControl if it has changed.
+     * Used when the mobility model does not emit periodic updates.
+     */
+    void refreshPosition();
     cModule *getHostModule() const { return hostModule; }
 
     /** Register with ChannelControl and subscribe to hostPos*/
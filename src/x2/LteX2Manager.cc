@@ -18,6 +18,7 @@
 Define_Module(LteX2Manager);
 
 LteX2Manager::LteX2Manager() {
+    directTransport_ = false;
 }
 
 LteX2Manager::~LteX2Manager() {
@@ -29,6 +30,15 @@ void LteX2Manager::initialize(int stage)
     {
         // get the node id
         nodeId_ = getAncestorPar("macCellId");
+
+        std::string transport = par("x2Transport").stdstringValue();
+        if (transport == "direct")
+            directTransport_ = true;
+        else if (transport != "sctp")
+            throw cRuntimeError("LteX2Manager::initialize - unknown X2 transport %s", transport.c_str());
+        x2Latency_ = par("x2Latency");
+        x2Bandwidth_ = par("x2Bandwidth");
+        x2LossProbability_ = par("x2LossProbability");
     }
     else if (stage == inet::INITSTAGE_NETWORK_LAYER_3)
     {
@@ -76,7 +86,14 @@ void LteX2Manager::handleMessage(cMessage *msg)
     cGate* incoming = pkt->getArrivalGate();
 
     // the incoming gate is part of a gate vector, so get the base name
-    if (strcmp(incoming->getBaseName(), "dataPort") == 0)
+    if (incoming == gate("directIn"))
+    {
+        // incoming data from the X2 manager of a peering eNB
+        EV << "LteX2Manager::handleMessage - Received message from peer " << check_and_cast<LteX2Message*>(pkt)->getSourceId() << endl;
+
+        fromX2(pkt);
+    }
+    else if (strcmp(incoming->getBaseName(), "dataPort") == 0)
     {
         // incoming data from LTE stack
         EV << "LteX2Manager::handleMessage - Received message from LTE stack" << endl;
@@ -125,6 +142,12 @@ void LteX2Manager::fromStack(cPacket* pkt)
             x2msg->setSourceId(nodeId_);
             x2msg->setDestinationId(targetEnb);
 
+            if (directTransport_)
+            {
+                sendToPeer(x2msg, targetEnb);
+                continue;
+            }
+
             // send to the gate connected to the GTPUser module
             cGate* outputGate = gate("x2Gtp$o");
             send(x2msg, outputGate);
@@ -142,6 +165,12 @@ void LteX2Manager::fromStack(cPacket* pkt)
             x2msg_dup->setSourceId(nodeId_);
             x2msg_dup->setDestinationId(*it);
 
+            if (directTransport_)
+            {
+                sendToPeer(x2msg_dup, *it);
+                continue;
+            }
+
             // select the index for the output gate (it belongs to a vector)
             int gateIndex = x2InterfaceTable_[*it];
             cGate* outputGate = gate("x2$o",gateIndex);
@@ -172,3 +201,38 @@ void LteX2Manager::fromX2(cPacket* pkt)
     EV << "LteX2Manager::fromX2 - send X2MSG to LTE stack" << endl;
     send(PK(x2msg), outGate);
 }
+
+void LteX2Manager::sendToPeer(LteX2Message* x2msg, X2NodeId destId)
+{
+    if (x2LossProbability_ > 0 && uniform(0, 1) < x2LossProbability_)
+    {
+        EV << "LteX2Manager::sendToPeer - X2 message to eNB " << destId << " lost" << endl;
+        delete x2msg;
+        return;
+    }
+
+    std::map<X2NodeId, LteX2Manager*>::iterator pt = peerManagers_.find(destId);
+    if (pt == peerManagers_.end())
+    {
+        cModule* enb = getSimulation()->getModule(getBinder()->getOmnetId(destId));
+        if (enb == NULL)
+            throw cRuntimeError("LteX2Manager::sendToPeer - eNB %d not found", destId);
+        LteX2Manager* peer = check_and_cast<LteX2Manager*>(enb->getSubmodule("nic")->getSubmodule("x2Manager"));
+        pt = peerManagers_.insert(std::pair<X2NodeId, LteX2Manager*>(destId, peer)).first;
+    }
+
+    // messages towards the same eNB are serialized on the link
+    simtime_t txStart = NOW;
+    simtime_t txDuration = SIMTIME_ZERO;
+    if (x2Bandwidth_ > 0)
+    {
+        std::map<X2NodeId, simtime_t>::iterator bt = x2LinkBusyUntil_.find(destId);
+        if (bt != x2LinkBusyUntil_.end() && bt->second > txStart)
+            txStart = bt->second;
+        txDuration = x2msg->getBitLength() / x2Bandwidth_;
+        x2LinkBusyUntil_[destId] = txStart + txDuration;
+    }
+
+    EV << "LteX2Manager::sendToPeer - send X2 message to eNB " << destId << endl;
+    sendDirect(x2msg, txStart - NOW + txDuration + x2Latency_, SIMTIME_ZERO, pt->second->gate("directIn"));
+}
@@ -32,6 +32,19 @@ class LteX2Manager : public cSimpleModule {
     // where the X2AP for that destination is connected to
     std::map<X2NodeId, int> x2InterfaceTable_;
 
+    // direct transport: X2 messages are delivered to the peering LteX2Managers
+    // without going through the X2Apps and the IP stack
+    bool directTransport_;
+    simtime_t x2Latency_;
+    double x2Bandwidth_;
+    double x2LossProbability_;
+
+    // for each destination ID, the time the direct X2 link towards it becomes idle
+    std::map<X2NodeId, simtime_t> x2LinkBusyUntil_;
+
+    // for each destination ID, the LteX2Manager of that eNodeB (direct transport)
+    std::map<X2NodeId, LteX2Manager*> peerManagers_;
+
 protected:
 
     void initialize(int stage);
@@ -41,6 +54,9 @@ protected:
     virtual void fromStack(cPacket* pkt);
     virtual void fromX2(cPacket* pkt);
 
+    // delivers a X2 message to the LteX2Manager of the destination eNodeB (direct transport)
+    virtual void sendToPeer(LteX2Message* x2msg, X2NodeId destId);
+
 public:
     LteX2Manager();
     virtual ~LteX2Manager();
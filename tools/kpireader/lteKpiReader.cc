@@ -0,0 +1,212 @@
+//
+//                           SimuLTE
+//
+// This file is part of a software released under the license included in file
+// "license.pdf". This license can be also found at http://www.ltesimulator.com/
+// The above file and the present reference are part of the software itself,
+// and cannot be removed from it.
+//
+
+//
+// Standalone reader for the binary columnar KPI files written by the
+// lteKpi result recorder.
+//
+//   lteKpiReader <file.kpi>                     list streams
+//   lteKpiReader <file.kpi> <name> [<module>]   dump rows as CSV
+//
+// <name> is the statistic name and <module> an optional substring of
+// the module path. Times are printed in seconds.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include "LteKpiFormat.h"
+
+struct Stream
+{
+    std::string module;
+    std::string name;
+    uint64_t rows;
+};
+
+struct Chunk
+{
+    uint64_t offset;
+    unsigned int stream;
+    unsigned int rows;
+    int64_t firstTime;
+    int64_t lastTime;
+};
+
+static void fail(const char* msg)
+{
+    fprintf(stderr, "lteKpiReader: %s\n", msg);
+    exit(1);
+}
+
+static void readAt(FILE* f, uint64_t offset, void* buf, size_t len)
+{
+    if (fseek(f, (long) offset, SEEK_SET) != 0 || fread(buf, 1, len, f) != len)
+        fail("truncated file");
+}
+
+static std::string readString(const unsigned char*& p, const unsigned char* end)
+{
+    if (end - p < 2)
+        fail("corrupted index");
+    unsigned int len = LteKpi::getFixed(p, 2);
+    p += 2;
+    if ((unsigned int) (end - p) < len)
+        fail("corrupted index");
+    std::string s((const char*) p, len);
+    p += len;
+    return s;
+}
+
+static void dumpChunk(FILE* f, const Chunk& c, const Stream& s, double scale)
+{
+    unsigned char header[12];
+    readAt(f, c.offset, header, sizeof(header));
+    unsigned int rows = LteKpi::getFixed(header + 4, 4);
+    unsigned int bytes = LteKpi::getFixed(header + 8, 4);
+    std::vector<unsigned char> payload(bytes);
+    if (bytes > 0 && fread(&payload[0], 1, bytes, f) != bytes)
+        fail("truncated chunk");
+
+    const unsigned char* p = payload.empty() ? NULL : &payload[0];
+    const unsigned char* end = p + bytes;
+    std::vector<int64_t> times(rows);
+    std::vector<int64_t> ids(rows);
+    uint64_t v;
+    int64_t prev = 0;
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        if (!LteKpi::getVarint(p, end, v))
+            fail("corrupted time column");
+        prev += LteKpi::unzigzag(v);
+        times[i] = prev;
+    }
+    prev = 0;
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        if (!LteKpi::getVarint(p, end, v))
+            fail("corrupted id column");
+        prev += LteKpi::unzigzag(v);
+        ids[i] = prev;
+    }
+    uint64_t bits = 0;
+    for (unsigned int i = 0; i < rows; i++)
+    {
+        if (!LteKpi::getVarint(p, end, v))
+            fail("corrupted value column");
+        bits ^= v;
+        printf("%s,%s,%.12g,%lld,%.17g\n", s.module.c_str(), s.name.c_str(), times[i] * scale,
+            (long long) ids[i], LteKpi::bitsDouble(bits));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 4)
+    {
+        fprintf(stderr, "usage: %s <file.kpi> [<statistic> [<module substring>]]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* f = fopen(argv[1], "rb");
+    if (f == NULL)
+        fail("cannot open file");
+
+    unsigned char header[LteKpi::HEADER_SIZE];
+    readAt(f, 0, header, sizeof(header));
+    if (memcmp(header, LteKpi::MAGIC, sizeof(LteKpi::MAGIC)) != 0)
+        fail("not a KPI file");
+    if (LteKpi::getFixed(header + 8, 4) != LteKpi::VERSION)
+        fail("unsupported version");
+    int scaleExp = (int32_t) LteKpi::getFixed(header + 12, 4);
+    double scale = pow(10.0, scaleExp);
+
+    // locate the index through the trailer
+    if (fseek(f, 0, SEEK_END) != 0)
+        fail("cannot seek");
+    long size = ftell(f);
+    if (size < (long) (LteKpi::HEADER_SIZE + LteKpi::TRAILER_SIZE))
+        fail("file too short (was the run finished?)");
+    unsigned char trailer[LteKpi::TRAILER_SIZE];
+    readAt(f, size - LteKpi::TRAILER_SIZE, trailer, sizeof(trailer));
+    if (memcmp(trailer + 8, LteKpi::MAGIC, sizeof(LteKpi::MAGIC)) != 0)
+        fail("missing index (was the run finished?)");
+    uint64_t indexOffset = LteKpi::getFixed(trailer, 8);
+    if (indexOffset > (uint64_t) size - LteKpi::TRAILER_SIZE)
+        fail("corrupted trailer");
+
+    std::vector<unsigned char> index(size - LteKpi::TRAILER_SIZE - indexOffset);
+    if (!index.empty())
+        readAt(f, indexOffset, &index[0], index.size());
+    const unsigned char* p = index.empty() ? NULL : &index[0];
+    const unsigned char* end = p + index.size();
+
+    if (end - p < 4)
+        fail("corrupted index");
+    unsigned int numStreams = LteKpi::getFixed(p, 4);
+    p += 4;
+    std::vector<Stream> streams(numStreams);
+    for (unsigned int i = 0; i < numStreams; i++)
+    {
+        if (end - p < 4)
+            fail("corrupted index");
+        unsigned int id = LteKpi::getFixed(p, 4);
+        p += 4;
+        if (id >= numStreams)
+            fail("corrupted index");
+        streams[id].module = readString(p, end);
+        streams[id].name = readString(p, end);
+        streams[id].rows = 0;
+    }
+
+    if (end - p < 4)
+        fail("corrupted index");
+    unsigned int numChunks = LteKpi::getFixed(p, 4);
+    p += 4;
+    std::vector<Chunk> chunks(numChunks);
+    for (unsigned int i = 0; i < numChunks; i++)
+    {
+        if (end - p < 32)
+            fail("corrupted index");
+        chunks[i].offset = LteKpi::getFixed(p, 8);
+        chunks[i].stream = LteKpi::getFixed(p + 8, 4);
+        chunks[i].rows = LteKpi::getFixed(p + 12, 4);
+        chunks[i].firstTime = (int64_t) LteKpi::getFixed(p + 16, 8);
+        chunks[i].lastTime = (int64_t) LteKpi::getFixed(p + 24, 8);
+        p += 32;
+        if (chunks[i].stream >= numStreams)
+            fail("corrupted index");
+        streams[chunks[i].stream].rows += chunks[i].rows;
+    }
+
+    if (argc == 2)
+    {
+        printf("module,statistic,rows\n");
+        for (unsigned int i = 0; i < numStreams; i++)
+            printf("%s,%s,%llu\n", streams[i].module.c_str(), streams[i].name.c_str(),
+                (unsigned long long) streams[i].rows);
+    }
+    else
+    {
+        std::string name = argv[2];
+        std::string module = (argc == 4) ? argv[3] : "";
+        printf("module,statistic,time,id,value\n");
+        for (unsigned int i = 0; i < numChunks; i++)
+        {
+            const Stream& s = streams[chunks[i].stream];
+            if (s.name != name || s.module.find(module) == std::string::npos)
+                continue;
+            dumpChunk(f, chunks[i], s, scale);
+        }
+    }
+
+    fclose(f);
+    return 0;
+}